@@ -0,0 +1,103 @@
+/*
+  Scaling of the parallel element loop from 1 to N threads for the 24-DOF
+  hexahedral element strain energy on a structured mesh: the residual from a
+  reverse sweep per element, and the residual and dense Jacobian from
+  hextract per element.
+
+  Usage: bench_assembly [max_threads]
+*/
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dassembly.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+using T = double;
+
+// Time the residual and the Jacobian assembly with nthreads threads
+void time_assembly(index_t nthreads, const Mat<T, 8, 3>& dN, double& tres,
+                   double& tjac) {
+  ThreadPool pool(nthreads);
+  auto make_local = [&]() { return Bench::make_energy_plan(dN); };
+
+  // Residual on a 24 x 24 x 24 mesh
+  {
+    const index_t n = 24;
+    std::vector<index_t> conn = Bench::make_hex_mesh(n);
+    ElementAssembler<T, 8, 3> assembler(n * n * n, conn.data(), pool);
+    std::vector<T> x(assembler.get_num_dof()), res(assembler.get_num_dof());
+    Bench::random_fill(x.size(), x.data());
+
+    auto kernel = [&](auto& plan, index_t elem, auto& re) {
+      auto& u = plan.template get<0>();
+      assembler.gather(elem, x.data(), u.value());
+      Bench::energy_residual_kernel(plan, re);
+    };
+    tres = 1e-6 * Bench::time_per_call(
+                      [&]() {
+                        assembler.add_residual(make_local, kernel, res.data());
+                        Bench::do_not_optimize(res.data());
+                      },
+                      5, 3);
+  }
+
+  // Residual and dense Jacobian on an 8 x 8 x 8 mesh
+  {
+    const index_t n = 8;
+    std::vector<index_t> conn = Bench::make_hex_mesh(n);
+    ElementAssembler<T, 8, 3> assembler(n * n * n, conn.data(), pool);
+    const index_t ndof = assembler.get_num_dof();
+    std::vector<T> x(ndof), res(ndof), jac(ndof * ndof);
+    Bench::random_fill(x.size(), x.data());
+
+    auto kernel = [&](auto& plan, index_t elem, auto& re, auto& ke) {
+      auto& u = plan.template get<0>();
+      assembler.gather(elem, x.data(), u.value());
+      Bench::energy_kernel(plan, re, ke);
+    };
+    tjac = 1e-6 * Bench::time_per_call(
+                      [&]() {
+                        assembler.add_jacobian(make_local, kernel, res.data(),
+                                               jac.data());
+                        Bench::do_not_optimize(jac.data());
+                      },
+                      5, 3);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  index_t max_threads = std::thread::hardware_concurrency();
+  if (argc > 1) {
+    max_threads = std::atoi(argv[1]);
+  }
+  if (max_threads < 1) {
+    max_threads = 1;
+  }
+
+  Mat<T, 8, 3> dN;
+  Bench::random_fill(24, &dN[0]);
+
+  std::printf("%8s  %14s  %8s  %14s  %8s\n", "threads", "residual (ms)",
+              "speedup", "jacobian (ms)", "speedup");
+  double tres1 = 0.0, tjac1 = 0.0;
+  for (index_t nthreads = 1; nthreads <= max_threads;) {
+    double tres, tjac;
+    time_assembly(nthreads, dN, tres, tjac);
+    if (nthreads == 1) {
+      tres1 = tres;
+      tjac1 = tjac;
+    }
+    std::printf("%8d  %14.2f  %7.2fx  %14.2f  %7.2fx\n", nthreads, tres,
+                tres1 / tres, tjac, tjac1 / tjac);
+
+    if (nthreads == max_threads) {
+      break;
+    }
+    nthreads = std::min(2 * nthreads, max_threads);
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+/*
+  Cost of adding 24 x 24 element matrices into a block-CSR matrix on a
+  structured hexahedral mesh: with the block positions found by a search for
+  every element, with the precomputed per-element positions, and with the
+  precomputed positions and atomic additions. The time to compute one element
+  residual and Jacobian of the strain energy is given for comparison.
+*/
+#include <cstdio>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dsparse.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+using T = double;
+
+// Add the element matrix by searching for each block in its row
+void add_element_search(BSRMat<T, 3>& A, const index_t nodes[],
+                        const Mat<T, 24, 24>& ke) {
+  for (index_t a = 0; a < 8; a++) {
+    for (index_t b = 0; b < 8; b++) {
+      T* blk = A.get_block(A.find_block(nodes[a], nodes[b]));
+      for (index_t i = 0; i < 3; i++) {
+        for (index_t j = 0; j < 3; j++) {
+          blk[3 * i + j] += ke(3 * a + i, 3 * b + j);
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  const index_t n = 32, nelems = n * n * n;
+  std::vector<index_t> conn = Bench::make_hex_mesh(n);
+  BSRMat<T, 3> A(nelems, 8, conn.data());
+
+  Mat<T, 24, 24> ke;
+  Bench::random_fill(24 * 24, &ke[0]);
+
+  double tsearch = Bench::time_per_call(
+      [&]() {
+        for (index_t e = 0; e < nelems; e++) {
+          add_element_search(A, &conn[8 * e], ke);
+        }
+        Bench::do_not_optimize(A.vals.data());
+      },
+      3);
+  double toffsets = Bench::time_per_call(
+      [&]() {
+        for (index_t e = 0; e < nelems; e++) {
+          A.add_element(e, ke);
+        }
+        Bench::do_not_optimize(A.vals.data());
+      },
+      3);
+  double tatomic = Bench::time_per_call(
+      [&]() {
+        for (index_t e = 0; e < nelems; e++) {
+          A.add_element_atomic(e, ke);
+        }
+        Bench::do_not_optimize(A.vals.data());
+      },
+      3);
+
+  // One element residual and Jacobian for comparison
+  Mat<T, 8, 3> dN;
+  Bench::random_fill(24, &dN[0]);
+  auto plan = Bench::make_energy_plan(dN);
+  Bench::random_fill(24, &plan.get<0>().value()[0]);
+  Vec<T, 24> re;
+  double tkernel = Bench::time_per_call(
+      [&]() {
+        Bench::energy_kernel(plan, re, ke);
+        Bench::do_not_optimize(&ke(0, 0));
+      },
+      20000);
+
+  std::printf("%d elements, %d blocks\n", nelems, A.get_num_blocks());
+  std::printf("%-24s  %12s\n", "", "ns / element");
+  std::printf("%-24s  %12.1f\n", "search", tsearch / nelems);
+  std::printf("%-24s  %12.1f\n", "precomputed positions", toffsets / nelems);
+  std::printf("%-24s  %12.1f\n", "atomic", tatomic / nelems);
+  std::printf("%-24s  %12.1f\n", "element kernel", tkernel);
+  return 0;
+}
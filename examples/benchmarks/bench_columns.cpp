@@ -0,0 +1,111 @@
+/*
+  Jacobian assembly of a few 81-DOF quadratic hexahedral elements with the
+  elements split between the threads, and with the columns of each element
+  Jacobian split between the threads, from 1 to N threads. Both speedups are
+  relative to the element loop on one thread.
+
+  Usage: bench_columns [max_threads]
+*/
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dassembly.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+using T = double;
+constexpr int nnodes = 27, ndof = 3 * nnodes;
+
+// Connectivity of a structured mesh of n x n x n 27-node hexahedral elements
+std::vector<index_t> make_quadratic_hex_mesh(index_t n) {
+  std::vector<index_t> conn;
+  auto node = [&](index_t i, index_t j, index_t k) {
+    return i + (2 * n + 1) * (j + (2 * n + 1) * k);
+  };
+  for (index_t k = 0; k < n; k++) {
+    for (index_t j = 0; j < n; j++) {
+      for (index_t i = 0; i < n; i++) {
+        for (index_t c = 0; c < 3; c++) {
+          for (index_t b = 0; b < 3; b++) {
+            for (index_t a = 0; a < 3; a++) {
+              conn.push_back(node(2 * i + a, 2 * j + b, 2 * k + c));
+            }
+          }
+        }
+      }
+    }
+  }
+  return conn;
+}
+
+int main(int argc, char* argv[]) {
+  index_t max_threads = std::thread::hardware_concurrency();
+  if (argc > 1) {
+    max_threads = std::atoi(argv[1]);
+  }
+  if (max_threads < 1) {
+    max_threads = 1;
+  }
+
+  Mat<T, nnodes, 3> dN;
+  Bench::random_fill(ndof, &dN[0]);
+
+  const index_t n = 2;
+  std::vector<index_t> conn = make_quadratic_hex_mesh(n);
+
+  auto make_local = [&]() { return Bench::make_energy_plan(dN); };
+
+  std::printf("%d elements with %d DOF\n", n * n * n, ndof);
+  std::printf("%8s  %14s  %8s  %14s  %8s\n", "threads", "elements (ms)",
+              "speedup", "columns (ms)", "speedup");
+  double telem1 = 0.0;
+  for (index_t nthreads = 1; nthreads <= max_threads;) {
+    ThreadPool pool(nthreads);
+    ElementAssembler<T, nnodes, 3> assembler(n * n * n, conn.data(), pool);
+    const index_t size = assembler.get_num_dof();
+    std::vector<T> x(size), res(size), jac(size * size);
+    Bench::random_fill(x.size(), x.data());
+
+    auto kernel = [&](auto& plan, index_t elem, auto& re, auto& ke) {
+      auto& u = plan.template get<0>();
+      assembler.gather(elem, x.data(), u.value());
+      Bench::energy_kernel(plan, re, ke);
+    };
+    auto column_kernel = [&](auto& plan, index_t elem, auto& re, auto& ke,
+                             index_t begin, index_t end) {
+      auto& u = plan.template get<0>();
+      assembler.gather(elem, x.data(), u.value());
+      Bench::energy_kernel(plan, re, ke, begin, end);
+    };
+
+    double telem = 1e-6 * Bench::time_per_call(
+                              [&]() {
+                                assembler.add_jacobian(make_local, kernel,
+                                                       res.data(), jac.data());
+                                Bench::do_not_optimize(jac.data());
+                              },
+                              20, 3);
+    double tcol = 1e-6 * Bench::time_per_call(
+                             [&]() {
+                               assembler.add_jacobian_by_columns(
+                                   make_local, column_kernel, res.data(),
+                                   jac.data());
+                               Bench::do_not_optimize(jac.data());
+                             },
+                             20, 3);
+    if (nthreads == 1) {
+      telem1 = telem;
+    }
+    std::printf("%8d  %14.3f  %7.2fx  %14.3f  %7.2fx\n", nthreads, telem,
+                telem1 / telem, tcol, telem1 / tcol);
+
+    if (nthreads == max_threads) {
+      break;
+    }
+    nthreads = std::min(2 * nthreads, max_threads);
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+  Compare the stack of the 24-DOF hexahedral element strain energy with and
+  without fusing SymIsotropic and SymMatMultTrace, for the gradient and the
+  Hessian extraction.
+*/
+#include <cstdio>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+constexpr int N = 3, nnodes = 8, ndof = N * nnodes;
+
+// Build the stack with the given stack factory and time the gradient and the
+// Hessian extraction
+template <class Make>
+void time_stack(const double u0[], const double dN0[], Make&& make,
+                double& tgrad, double& thess, Mat<double, ndof, ndof>& jac) {
+  A2DObj<Mat<double, N, nnodes>> u;
+  Mat<double, nnodes, N> dN;
+  for (int i = 0; i < ndof; i++) {
+    u.value()[i] = u0[i];
+    dN[i] = dN0[i];
+  }
+
+  A2DObj<Mat<double, N, N>> Ux;
+  A2DObj<SymMat<double, N>> E, S;
+  A2DObj<double> energy;
+  auto stack = make(MatMatMult(u, dN, Ux),
+                    MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                    SymIsotropic(double(0.35), double(0.51), E, S),
+                    SymMatMultTrace(E, S, energy));
+
+  tgrad = Bench::time_per_call(
+      [&]() {
+        stack.bzero();
+        energy.bvalue() = 1.0;
+        stack.reverse();
+        Bench::do_not_optimize(&u.bvalue()(0, 0));
+      },
+      200000);
+
+  thess = Bench::time_per_call(
+      [&]() {
+        stack.bzero();
+        energy.bvalue() = 1.0;
+        stack.hextract(u.pvalue(), u.hvalue(), jac);
+        Bench::do_not_optimize(&jac(0, 0));
+      },
+      20000);
+}
+
+int main() {
+  double u0[ndof], dN0[ndof];
+  Bench::random_fill(ndof, u0);
+  Bench::random_fill(ndof, dN0);
+
+  Mat<double, ndof, ndof> jac, jacf;
+  double tg, th, tgf, thf;
+  time_stack(
+      u0, dN0, [](auto&&... ops) { return MakeStack(std::move(ops)...); }, tg,
+      th, jac);
+  time_stack(
+      u0, dN0, [](auto&&... ops) { return MakeFusedStack(std::move(ops)...); },
+      tgf, thf, jacf);
+
+  double err = 0.0;
+  for (int i = 0; i < ndof * ndof; i++) {
+    err = std::max(err, std::fabs(jac[i] - jacf[i]));
+  }
+
+  std::printf("%-24s  %12s  %12s  %9s\n", "", "unfused (ns)", "fused (ns)",
+              "speedup");
+  std::printf("%-24s  %12.1f  %12.1f  %8.2fx\n", "gradient", tg, tgf,
+              tg / tgf);
+  std::printf("%-24s  %12.1f  %12.1f  %8.2fx\n", "hextract", th, thf,
+              th / thf);
+  std::printf("max difference %.3e\n", err);
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+  Compare the register-blocked MatMatMultCoreBlocked kernel against the
+  naive MatMatMultCoreGeneral fallback for the sizes that appear in shell and
+  20-node hex element computations. The last column is the kernel that
+  MatMatMultCore dispatches to.
+*/
+#include <cstdio>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+template <MatOp op>
+constexpr const char* op_name() {
+  return op == MatOp::NORMAL ? "N" : "T";
+}
+
+template <typename T, int M, int N, int P, MatOp opA, MatOp opB,
+          bool additive>
+void bench_case(const int ncalls) {
+  constexpr int Anrows = (opA == MatOp::NORMAL ? M : P);
+  constexpr int Ancols = (opA == MatOp::NORMAL ? P : M);
+  constexpr int Bnrows = (opB == MatOp::NORMAL ? P : N);
+  constexpr int Bncols = (opB == MatOp::NORMAL ? N : P);
+
+  T A[M * P], B[P * N], C[M * N];
+  Bench::random_fill(M * P, A);
+  Bench::random_fill(P * N, B);
+  Bench::random_fill(M * N, C);
+
+  double t_general = Bench::time_per_call(
+      [&]() {
+        MatMatMultCoreGeneral<T, Anrows, Ancols, Bnrows, Bncols, M, N, opA,
+                              opB, additive>(A, B, C);
+        Bench::do_not_optimize(C);
+      },
+      ncalls);
+
+  double t_blocked = Bench::time_per_call(
+      [&]() {
+        MatMatMultCoreBlocked<T, M, N, P, opA, opB, additive, false>(
+            T(1.0), A, B, C);
+        Bench::do_not_optimize(C);
+      },
+      ncalls);
+
+  constexpr bool blocked = MatMatMultUseBlocked<M, N, P, opA, opB>();
+  std::printf("%3d x %3d x %3d  %s%s  %-5s  %12.1f  %12.1f  %8.2fx  %s\n", M,
+              N, P, op_name<opA>(), op_name<opB>(), additive ? "add" : "set",
+              t_general, t_blocked, t_general / t_blocked,
+              blocked ? "blocked" : "general");
+}
+
+template <typename T, int M, int N, int P>
+void bench_size(const int ncalls) {
+  bench_case<T, M, N, P, MatOp::NORMAL, MatOp::NORMAL, false>(ncalls);
+  bench_case<T, M, N, P, MatOp::NORMAL, MatOp::TRANSPOSE, false>(ncalls);
+  bench_case<T, M, N, P, MatOp::TRANSPOSE, MatOp::NORMAL, false>(ncalls);
+  bench_case<T, M, N, P, MatOp::TRANSPOSE, MatOp::TRANSPOSE, false>(ncalls);
+  bench_case<T, M, N, P, MatOp::NORMAL, MatOp::NORMAL, true>(ncalls);
+}
+
+int main() {
+  using T = double;
+  std::printf("%-15s  %-2s  %-5s  %12s  %12s  %9s  %s\n", "M x N x P", "op",
+              "mode", "general (ns)", "blocked (ns)", "speedup", "dispatch");
+  bench_size<T, 6, 6, 6>(200000);
+  bench_size<T, 6, 6, 12>(100000);
+  bench_size<T, 8, 8, 8>(100000);
+  bench_size<T, 12, 12, 12>(50000);
+  bench_size<T, 8, 24, 8>(50000);
+  bench_size<T, 8, 24, 24>(20000);
+  bench_size<T, 24, 8, 24>(20000);
+  bench_size<T, 24, 24, 8>(20000);
+  bench_size<T, 24, 24, 16>(10000);
+  bench_size<T, 24, 24, 24>(5000);
+  return 0;
+}
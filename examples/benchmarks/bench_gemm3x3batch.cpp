@@ -0,0 +1,72 @@
+/*
+  Compare the batched 3x3 mat-mat kernels for each instruction set available
+  on this CPU against a loop over the single-matrix kernel, for an array of
+  matrices such as the Jacobian transformations at the quadrature points of
+  an element block.
+*/
+#include <cstdio>
+#include <vector>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+const char* isa_name(SimdISA isa) {
+  if (isa == SimdISA::AVX512) {
+    return "avx512";
+  } else if (isa == SimdISA::AVX2) {
+    return "avx2";
+  }
+  return "scalar";
+}
+
+template <MatOp opA, MatOp opB, bool additive>
+void bench_case(const char* name, const int n, const int ncalls) {
+  std::vector<double> A(9 * n), B(9 * n), C(9 * n);
+  Bench::random_fill(9 * n, A.data());
+  Bench::random_fill(9 * n, B.data());
+  Bench::random_fill(9 * n, C.data());
+
+  double t_loop = Bench::time_per_call(
+      [&]() {
+        for (int i = 0; i < n; i++) {
+          if constexpr (additive) {
+            MatMatMultCore3x3Add<double, opA, opB>(&A[9 * i], &B[9 * i],
+                                                   &C[9 * i]);
+          } else {
+            MatMatMultCore3x3<double, opA, opB>(&A[9 * i], &B[9 * i],
+                                                &C[9 * i]);
+          }
+        }
+        Bench::do_not_optimize(C.data());
+      },
+      ncalls);
+
+  for (SimdISA isa : {SimdISA::SCALAR, SimdISA::AVX2, SimdISA::AVX512}) {
+    if (isa > GetSimdISA()) {
+      continue;
+    }
+    double t = Bench::time_per_call(
+        [&]() {
+          MatMatMultCore3x3BatchISA<opA, opB, additive, false>(
+              isa, n, 1.0, A.data(), B.data(), C.data());
+          Bench::do_not_optimize(C.data());
+        },
+        ncalls);
+    std::printf("%6d  %-4s  %-7s  %12.2f  %12.2f  %8.2fx\n", n, name,
+                isa_name(isa), t_loop / n, t / n, t_loop / t);
+  }
+}
+
+int main() {
+  std::printf("%6s  %-4s  %-7s  %12s  %12s  %9s\n", "n", "op", "isa",
+              "loop (ns)", "batch (ns)", "speedup");
+  for (int n : {64, 1024, 16384}) {
+    int ncalls = 2000000 / n;
+    bench_case<MatOp::NORMAL, MatOp::NORMAL, false>("NN", n, ncalls);
+    bench_case<MatOp::TRANSPOSE, MatOp::NORMAL, false>("TN", n, ncalls);
+    bench_case<MatOp::NORMAL, MatOp::TRANSPOSE, true>("NT+", n, ncalls);
+  }
+  return 0;
+}
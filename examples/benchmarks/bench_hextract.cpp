@@ -0,0 +1,81 @@
+/*
+  Compare the column-by-column Hessian extraction with the block extraction
+  that carries K directions per sweep, for a 24-DOF hexahedral element strain
+  energy.
+*/
+#include <cstdio>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+constexpr int N = 3, nnodes = 8, ndof = N * nnodes;
+
+// Build the stack with the numeric type T and time the extraction
+template <typename T, class Extract>
+double time_extract(const double u0[], const double dN0[], Extract&& extract,
+                    Mat<double, ndof, ndof>& jac) {
+  A2DObj<Mat<T, N, nnodes>> u;
+  Mat<T, nnodes, N> dN;
+  for (int i = 0; i < ndof; i++) {
+    u.value()[i] = u0[i];
+    dN[i] = dN0[i];
+  }
+
+  A2DObj<Mat<T, N, N>> Ux;
+  A2DObj<SymMat<T, N>> E, S;
+  A2DObj<T> energy;
+  auto stack = MakeStack(MatMatMult(u, dN, Ux),
+                         MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                         SymIsotropic(double(0.35), double(0.51), E, S),
+                         SymMatMultTrace(E, S, energy));
+  energy.bvalue() = 1.0;
+
+  return Bench::time_per_call(
+      [&]() {
+        extract(stack, u, jac);
+        Bench::do_not_optimize(&jac(0, 0));
+      },
+      20000);
+}
+
+template <int K>
+double time_block(const double u0[], const double dN0[],
+                  Mat<double, ndof, ndof>& jac) {
+  return time_extract<simd<double, K>>(
+      u0, dN0,
+      [](auto& stack, auto& u, auto& jac) {
+        stack.template hextract_block<K>(u.pvalue(), u.hvalue(), jac);
+      },
+      jac);
+}
+
+int main() {
+  double u0[ndof], dN0[ndof];
+  Bench::random_fill(ndof, u0);
+  Bench::random_fill(ndof, dN0);
+
+  Mat<double, ndof, ndof> jac, jac4, jac8;
+  double t1 = time_extract<double>(
+      u0, dN0,
+      [](auto& stack, auto& u, auto& jac) {
+        stack.hextract(u.pvalue(), u.hvalue(), jac);
+      },
+      jac);
+  double t4 = time_block<4>(u0, dN0, jac4);
+  double t8 = time_block<8>(u0, dN0, jac8);
+
+  double err = 0.0;
+  for (int i = 0; i < ndof * ndof; i++) {
+    err = std::max(err, std::fabs(jac[i] - jac4[i]));
+    err = std::max(err, std::fabs(jac[i] - jac8[i]));
+  }
+
+  std::printf("%-24s  %12s  %9s\n", "", "time (ns)", "speedup");
+  std::printf("%-24s  %12.1f  %8.2fx\n", "hextract", t1, 1.0);
+  std::printf("%-24s  %12.1f  %8.2fx\n", "hextract_block<4>", t4, t1 / t4);
+  std::printf("%-24s  %12.1f  %8.2fx\n", "hextract_block<8>", t8, t1 / t8);
+  std::printf("max difference %.3e\n", err);
+  return 0;
+}
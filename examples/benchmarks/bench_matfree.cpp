@@ -0,0 +1,107 @@
+/*
+  Global Jacobian-vector products for the strain energy of a structured
+  hexahedral mesh: matrix-free with one element per kernel call and with 4
+  elements in the lanes of each kernel call, against the assembly of a
+  block-CSR Jacobian followed by its products. The matrix-free product
+  stores no matrix; the memory of the block-CSR matrix is printed.
+
+  Usage: bench_matfree [num_threads]
+*/
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dassembly.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+using T = double;
+
+// Time of one matrix-free product with K elements per kernel call
+template <index_t K, class Assembler>
+double time_matrix_free(Assembler& assembler, const Mat<T, 8, 3>& dN,
+                        const std::vector<T>& x, const std::vector<T>& p,
+                        std::vector<T>& y) {
+  using Tb = simd<T, K>;
+  Mat<Tb, 8, 3> dNb;
+  for (int i = 0; i < 24; i++) {
+    dNb[i] = dN[i];
+  }
+
+  auto kernel = [&](auto& plan, const index_t* elems, index_t count, auto& pe,
+                    auto& ye) {
+    auto& u = plan.template get<0>();
+    assembler.gather_lanes(elems, count, x.data(), u.value());
+    Bench::energy_product_kernel(plan, pe, ye);
+  };
+  auto jac = MakeMatrixFreeJacobian<K>(
+      assembler, [&]() { return Bench::make_energy_plan(dNb); }, kernel);
+
+  return 1e-6 * Bench::time_per_call(
+                    [&]() {
+                      jac.mult(p.data(), y.data());
+                      Bench::do_not_optimize(y.data());
+                    },
+                    5, 3);
+}
+
+int main(int argc, char* argv[]) {
+  index_t num_threads = std::thread::hardware_concurrency();
+  if (argc > 1) {
+    num_threads = std::atoi(argv[1]);
+  }
+
+  Mat<T, 8, 3> dN;
+  Bench::random_fill(24, &dN[0]);
+
+  const index_t n = 16, nelems = n * n * n;
+  std::vector<index_t> conn = Bench::make_hex_mesh(n);
+  ThreadPool pool(num_threads);
+  ElementAssembler<T, 8, 3> assembler(nelems, conn.data(), pool);
+  const index_t ndof = assembler.get_num_dof();
+  std::vector<T> x(ndof), p(ndof), y(ndof), res(ndof);
+  Bench::random_fill(x.size(), x.data());
+  Bench::random_fill(p.size(), p.data());
+
+  // Assemble the block-CSR Jacobian, then multiply
+  BSRMat<T, 3> bsr(nelems, 8, conn.data());
+  auto kernel = [&](auto& plan, index_t elem, auto& re, auto& ke) {
+    auto& u = plan.template get<0>();
+    assembler.gather(elem, x.data(), u.value());
+    Bench::energy_kernel(plan, re, ke);
+  };
+  auto make_local = [&]() { return Bench::make_energy_plan(dN); };
+  double tassemble = 1e-6 * Bench::time_per_call(
+                                [&]() {
+                                  bsr.zero();
+                                  assembler.add_jacobian(make_local, kernel,
+                                                         res.data(), bsr);
+                                  Bench::do_not_optimize(bsr.vals.data());
+                                },
+                                5, 3);
+  double tmult = 1e-6 * Bench::time_per_call(
+                            [&]() {
+                              bsr.mult(p.data(), y.data());
+                              Bench::do_not_optimize(y.data());
+                            },
+                            20, 3);
+
+  double tfree1 = time_matrix_free<1>(assembler, dN, x, p, y);
+  double tfree4 = time_matrix_free<4>(assembler, dN, x, p, y);
+
+  double mbytes =
+      1e-6 * (sizeof(T) * bsr.vals.size() +
+              sizeof(index_t) * (bsr.rowp.size() + bsr.cols.size()));
+  std::printf("%d threads, %d elements, %d DOF, BSR matrix %.1f MB\n",
+              pool.get_num_threads(), nelems, ndof, mbytes);
+  std::printf("%-24s  %10.3f ms\n", "BSR assembly", tassemble);
+  std::printf("%-24s  %10.3f ms\n", "BSR product", tmult);
+  std::printf("%-24s  %10.3f ms\n", "matrix-free, 1 lane", tfree1);
+  std::printf("%-24s  %10.3f ms\n", "matrix-free, 4 lanes", tfree4);
+  std::printf("Products for which the assembly pays off: %.1f (1 lane), "
+              "%.1f (4 lanes)\n",
+              tassemble / (tfree1 - tmult), tassemble / (tfree4 - tmult));
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+  Compare the compile-time sized LU cores used by MatInvCore and MatDetCore
+  for N = 4, 5 and 6 against a naive LU with a run-time dimension and
+  explicit row swaps, as typically written by hand outside of A2D.
+*/
+#include <cmath>
+#include <cstdio>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+// Naive LU with partial pivoting, returns the determinant and the inverse
+double naive_lu_inverse(const int n, const double A[], double Ainv[]) {
+  double LU[64], b[8];
+  int perm[8];
+  for (int i = 0; i < n * n; i++) {
+    LU[i] = A[i];
+  }
+  for (int i = 0; i < n; i++) {
+    perm[i] = i;
+  }
+
+  double det = 1.0;
+  for (int k = 0; k < n; k++) {
+    int p = k;
+    for (int i = k + 1; i < n; i++) {
+      if (std::fabs(LU[n * i + k]) > std::fabs(LU[n * p + k])) {
+        p = i;
+      }
+    }
+    if (p != k) {
+      for (int j = 0; j < n; j++) {
+        std::swap(LU[n * k + j], LU[n * p + j]);
+      }
+      std::swap(perm[k], perm[p]);
+      det = -det;
+    }
+    det *= LU[n * k + k];
+    for (int i = k + 1; i < n; i++) {
+      LU[n * i + k] /= LU[n * k + k];
+      for (int j = k + 1; j < n; j++) {
+        LU[n * i + j] -= LU[n * i + k] * LU[n * k + j];
+      }
+    }
+  }
+
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      b[i] = (perm[i] == j ? 1.0 : 0.0);
+    }
+    for (int i = 1; i < n; i++) {
+      for (int k = 0; k < i; k++) {
+        b[i] -= LU[n * i + k] * b[k];
+      }
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      for (int k = i + 1; k < n; k++) {
+        b[i] -= LU[n * i + k] * b[k];
+      }
+      b[i] /= LU[n * i + i];
+    }
+    for (int i = 0; i < n; i++) {
+      Ainv[n * i + j] = b[i];
+    }
+  }
+
+  return det;
+}
+
+template <int N>
+void bench_size(const int ncalls) {
+  double A[N * N], Ainv[N * N];
+  Bench::random_fill(N * N, A);
+  for (int i = 0; i < N; i++) {
+    A[N * i + i] += 1.0;
+  }
+
+  // Pass the dimension through a volatile so it is not known at compile time
+  volatile int n = N;
+  double det;
+  double t_naive = Bench::time_per_call(
+      [&]() {
+        det = naive_lu_inverse(n, A, Ainv);
+        Bench::do_not_optimize(Ainv);
+        Bench::do_not_optimize(&det);
+      },
+      ncalls);
+
+  double t_core = Bench::time_per_call(
+      [&]() {
+        MatInvCore<double, N>(A, Ainv);
+        det = MatDetCore<double, N>(A);
+        Bench::do_not_optimize(Ainv);
+        Bench::do_not_optimize(&det);
+      },
+      ncalls);
+
+  double t_det = Bench::time_per_call(
+      [&]() {
+        det = MatDetCore<double, N>(A);
+        Bench::do_not_optimize(&det);
+      },
+      ncalls);
+
+  std::printf("%3d  %14.1f  %14.1f  %8.2fx  %12.1f\n", N, t_naive, t_core,
+              t_naive / t_core, t_det);
+}
+
+int main() {
+  std::printf("%3s  %14s  %14s  %9s  %12s\n", "N", "naive LU (ns)",
+              "inv+det (ns)", "speedup", "det (ns)");
+  bench_size<4>(200000);
+  bench_size<5>(200000);
+  bench_size<6>(100000);
+  return 0;
+}
@@ -0,0 +1,114 @@
+/*
+  Load balance of the element loop for a mesh that mixes two element stacks:
+  a principal-strain model through SymEigs in the lower half of the mesh and
+  a linear SymIsotropic model in the upper half. The residual and the dense
+  Jacobian are assembled with the elements of each color split evenly
+  between the threads, and then with the work-stealing scheduler.
+
+  Usage: bench_scheduler [num_threads] [chunk_size]
+*/
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dassembly.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+using T = double;
+
+auto make_eigs_plan(const Mat<T, 8, 3>& dN) {
+  return MakeStackPlan<A2DObj<Mat<T, 8, 3>>, A2DObj<Mat<T, 3, 3>>,
+                       A2DObj<SymMat<T, 3>>, A2DObj<Vec<T, 3>>, A2DObj<T>>(
+      [&dN](auto& u, auto& Ux, auto& E, auto& eigs, auto& energy) {
+        return MakeStack(
+            uninit, MatMatMult<MatOp::TRANSPOSE, MatOp::NORMAL>(u, dN, Ux),
+            MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+            SymEigs(E, eigs), VecDot(eigs, eigs, energy));
+      });
+}
+
+auto make_linear_plan(const Mat<T, 8, 3>& dN) {
+  return MakeStackPlan<A2DObj<Mat<T, 8, 3>>, A2DObj<Mat<T, 3, 3>>,
+                       A2DObj<SymMat<T, 3>>, A2DObj<SymMat<T, 3>>, A2DObj<T>>(
+      [&dN](auto& u, auto& Ux, auto& E, auto& S, auto& energy) {
+        return MakeStack(
+            uninit, MatMatMult<MatOp::TRANSPOSE, MatOp::NORMAL>(u, dN, Ux),
+            MatGreenStrain<GreenStrainType::LINEAR>(Ux, E),
+            SymIsotropic(T(0.35), T(0.51), E, S),
+            SymMatMultTrace(E, S, energy));
+      });
+}
+
+// Local state of a thread, one plan for each element type
+template <class EigsPlan, class LinearPlan>
+struct ElementPlans {
+  EigsPlan eigs;
+  LinearPlan linear;
+};
+
+int main(int argc, char* argv[]) {
+  index_t num_threads = std::thread::hardware_concurrency();
+  index_t chunk_size = 4;
+  if (argc > 1) {
+    num_threads = std::atoi(argv[1]);
+  }
+  if (argc > 2) {
+    chunk_size = std::atoi(argv[2]);
+  }
+
+  Mat<T, 8, 3> dN;
+  Bench::random_fill(24, &dN[0]);
+
+  const index_t n = 10, nelems = n * n * n;
+  std::vector<index_t> conn = Bench::make_hex_mesh(n);
+  ThreadPool pool(num_threads);
+  ElementAssembler<T, 8, 3> assembler(nelems, conn.data(), pool);
+  const index_t ndof = assembler.get_num_dof();
+  std::vector<T> x(ndof), res(ndof), jac(ndof * ndof);
+  Bench::random_fill(x.size(), x.data());
+
+  auto make_local = [&]() {
+    using Plans = ElementPlans<decltype(make_eigs_plan(dN)),
+                               decltype(make_linear_plan(dN))>;
+    return Plans{make_eigs_plan(dN), make_linear_plan(dN)};
+  };
+  auto kernel = [&](auto& plans, index_t elem, auto& re, auto& ke) {
+    if (elem < nelems / 2) {
+      assembler.gather(elem, x.data(), plans.eigs.template get<0>().value());
+      Bench::energy_kernel(plans.eigs, re, ke);
+    } else {
+      assembler.gather(elem, x.data(), plans.linear.template get<0>().value());
+      Bench::energy_kernel(plans.linear, re, ke);
+    }
+  };
+  auto assemble = [&]() {
+    assembler.add_jacobian(make_local, kernel, res.data(), jac.data());
+    Bench::do_not_optimize(jac.data());
+  };
+
+  double tstatic = 1e-6 * Bench::time_per_call(assemble, 5, 3);
+
+  WorkStealingScheduler scheduler(pool, chunk_size);
+  assembler.set_scheduler(&scheduler);
+  double tsteal = 1e-6 * Bench::time_per_call(assemble, 5, 3);
+
+  std::printf("%d threads, %d elements, chunks of %d elements\n",
+              pool.get_num_threads(), nelems, chunk_size);
+  std::printf("%-16s  %10.2f ms\n", "even split", tstatic);
+  std::printf("%-16s  %10.2f ms  %7.2fx\n", "work stealing", tsteal,
+              tstatic / tsteal);
+
+  // The statistics cover the 15 timed calls
+  std::printf("\n%8s  %10s  %8s  %8s  %10s  %10s\n", "worker", "elements",
+              "chunks", "steals", "busy (ms)", "idle (ms)");
+  const std::vector<WorkerStats>& stats = scheduler.get_stats();
+  for (index_t i = 0; i < index_t(stats.size()); i++) {
+    std::printf("%8d  %10d  %8d  %8d  %10.2f  %10.2f\n", i, stats[i].num_items,
+                stats[i].num_chunks, stats[i].num_steals,
+                1e3 * stats[i].busy_time, 1e3 * stats[i].idle_time);
+  }
+  return 0;
+}
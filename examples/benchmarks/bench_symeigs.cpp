@@ -0,0 +1,54 @@
+/*
+  Compare the closed-form 3x3 symmetric eigensolver used by SymEigs for N = 3
+  against the general Householder/QL solver, with and without eigenvectors.
+*/
+#include <cstdio>
+
+#include "a2dcore.h"
+#include "bench_utils.h"
+
+using namespace A2D;
+
+int main() {
+  // A set of random strain-like tensors
+  constexpr int nmats = 64;
+  double A[nmats][6], eigs[3], Q[9];
+  for (int i = 0; i < nmats; i++) {
+    Bench::random_fill(6, A[i]);
+  }
+
+  const int ncalls = 100000;
+  int k = 0;
+  double t_general = Bench::time_per_call(
+      [&]() {
+        SymEigsGeneral<double, 3>(A[k++ % nmats], eigs, Q);
+        Bench::do_not_optimize(Q);
+      },
+      ncalls);
+  double t_closed = Bench::time_per_call(
+      [&]() {
+        SymEigs3x3(A[k++ % nmats], eigs, Q);
+        Bench::do_not_optimize(Q);
+      },
+      ncalls);
+  double t_general_eigs = Bench::time_per_call(
+      [&]() {
+        SymEigsGeneral<double, 3>(A[k++ % nmats], eigs);
+        Bench::do_not_optimize(eigs);
+      },
+      ncalls);
+  double t_closed_eigs = Bench::time_per_call(
+      [&]() {
+        SymEigs3x3(A[k++ % nmats], eigs);
+        Bench::do_not_optimize(eigs);
+      },
+      ncalls);
+
+  std::printf("%-20s  %14s  %14s  %9s\n", "", "general (ns)", "3x3 (ns)",
+              "speedup");
+  std::printf("%-20s  %14.1f  %14.1f  %8.2fx\n", "eigenvalues", t_general_eigs,
+              t_closed_eigs, t_general_eigs / t_closed_eigs);
+  std::printf("%-20s  %14.1f  %14.1f  %8.2fx\n", "with eigenvectors",
+              t_general, t_closed, t_general / t_closed);
+  return 0;
+}
@@ -0,0 +1,150 @@
+#ifndef A2D_BENCH_UTILS_H
+#define A2D_BENCH_UTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "a2dcore.h"
+
+namespace A2D {
+namespace Bench {
+
+// Prevent the compiler from optimizing away the computations that produce
+// the data at ptr
+template <typename T>
+inline void do_not_optimize(T* ptr) {
+  asm volatile("" : : "g"(ptr) : "memory");
+}
+
+// Fill an array with random values in [-0.5, 0.5]
+template <typename T>
+void random_fill(int n, T* data) {
+  for (int i = 0; i < n; i++) {
+    data[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+}
+
+// Return the best average time in nanoseconds per call over several trials
+template <class Functor>
+double time_per_call(Functor&& func, const int ncalls, const int ntrials = 5) {
+  double best = 1e300;
+  for (int trial = 0; trial < ntrials; trial++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < ncalls; i++) {
+      func();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    double t = std::chrono::duration<double, std::nano>(stop - start).count();
+    if (t / ncalls < best) {
+      best = t / ncalls;
+    }
+  }
+  return best;
+}
+
+// Connectivity of a structured mesh of n x n x n hexahedral elements
+inline std::vector<index_t> make_hex_mesh(index_t n) {
+  std::vector<index_t> conn;
+  auto node = [&](index_t i, index_t j, index_t k) {
+    return i + (n + 1) * (j + (n + 1) * k);
+  };
+  for (index_t k = 0; k < n; k++) {
+    for (index_t j = 0; j < n; j++) {
+      for (index_t i = 0; i < n; i++) {
+        index_t nodes[8] = {node(i, j, k),         node(i + 1, j, k),
+                            node(i + 1, j + 1, k), node(i, j + 1, k),
+                            node(i, j, k + 1),     node(i + 1, j, k + 1),
+                            node(i + 1, j + 1, k + 1),
+                            node(i, j + 1, k + 1)};
+        conn.insert(conn.end(), nodes, nodes + 8);
+      }
+    }
+  }
+  return conn;
+}
+
+// Plan for the strain energy of an element with nnodes nodes, with the
+// displacements in get<0>() and the energy in get<4>(). The stack reads dN,
+// which must outlive the plan.
+template <typename T, int nnodes>
+auto make_energy_plan(const Mat<T, nnodes, 3>& dN) {
+  return MakeStackPlan<A2DObj<Mat<T, nnodes, 3>>, A2DObj<Mat<T, 3, 3>>,
+                       A2DObj<SymMat<T, 3>>, A2DObj<SymMat<T, 3>>, A2DObj<T>>(
+      [&dN](auto& u, auto& Ux, auto& E, auto& S, auto& energy) {
+        return MakeStack(
+            uninit, MatMatMult<MatOp::TRANSPOSE, MatOp::NORMAL>(u, dN, Ux),
+            MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+            SymIsotropic(T(0.35), T(0.51), E, S),
+            SymMatMultTrace(E, S, energy));
+      });
+}
+
+// Residual of the element from a plan made by make_energy_plan(), with the
+// displacements already in get<0>().value()
+template <class Plan, class ElemVec>
+void energy_residual_kernel(Plan& plan, ElemVec& re) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  u.bvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  plan.get_stack().reverse();
+  for (int i = 0; i < u.value().ncomp; i++) {
+    re[i] = u.bvalue()[i];
+  }
+}
+
+// Residual and Jacobian of the element from the plan
+template <class Plan, class ElemVec, class ElemMat>
+void energy_kernel(Plan& plan, ElemVec& re, ElemMat& ke) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  u.bvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  plan.get_stack().hextract(u.pvalue(), u.hvalue(), ke);  // Calls reverse()
+  for (int i = 0; i < u.value().ncomp; i++) {
+    re[i] = u.bvalue()[i];
+  }
+}
+
+// Residual and the Jacobian columns [begin, end) of the element
+template <class Plan, class ElemVec, class ElemMat>
+void energy_kernel(Plan& plan, ElemVec& re, ElemMat& ke, index_t begin,
+                   index_t end) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  u.bvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  plan.get_stack().hextract_range(u.pvalue(), u.hvalue(), ke, begin, end);
+  for (int i = 0; i < u.value().ncomp; i++) {
+    re[i] = u.bvalue()[i];
+  }
+}
+
+// Product ye = Ke * pe of the element Jacobian with a direction
+template <class Plan, class ElemVec>
+void energy_product_kernel(Plan& plan, const ElemVec& pe, ElemVec& ye) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  plan.get_stack().hzero();
+  u.bvalue().zero();
+  u.hvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  for (int i = 0; i < u.value().ncomp; i++) {
+    u.pvalue()[i] = pe[i];
+  }
+  plan.get_stack().hproduct();
+  for (int i = 0; i < u.value().ncomp; i++) {
+    ye[i] = u.hvalue()[i];
+  }
+}
+
+}  // namespace Bench
+}  // namespace A2D
+
+#endif  // A2D_BENCH_UTILS_H
@@ -3,25 +3,30 @@
 
 // Key objects
 
+#include "ad/a2dbatch.h"
 #include "ad/a2dmat.h"
 #include "ad/a2dobj.h"
 #include "ad/a2dstack.h"
 #include "ad/a2dvec.h"
+#include "ad/a2dview.h"
 
 // Operations
 
 #include "ad/a2dgemm.h"
 #include "ad/a2dgreenstrain.h"
+#include "ad/a2dfusion.h"
 #include "ad/a2dhadamard.h"
 #include "ad/a2disotropic.h"
 #include "ad/a2dmatdet.h"
 #include "ad/a2dmatinv.h"
+#include "ad/a2dmatsolve.h"
 #include "ad/a2dmatsum.h"
 #include "ad/a2dmattovec.h"
 #include "ad/a2dmattrace.h"
 #include "ad/a2dmatvecmult.h"
 #include "ad/a2dquaternion.h"
 #include "ad/a2dscalarops.h"
+#include "ad/a2dsymchol.h"
 #include "ad/a2dsymeigs.h"
 #include "ad/a2dsymmatmulttrace.h"
 #include "ad/a2dsymrk.h"
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 
 #ifndef __CUDACC__
@@ -65,6 +66,52 @@ enum class ADseed { b, p, h };
  */
 enum class FEVarType { DATA, GEOMETRY, STATE };
 
+/**
+ * @brief Tag to construct an object without initializing its entries
+ *
+ * Mat(uninit), SymMat(uninit) and Vec(uninit) skip the zero-fill of the
+ * default constructors. Use this for objects that are overwritten before
+ * they are read.
+ */
+struct uninit_t {
+  explicit uninit_t() = default;
+};
+inline constexpr uninit_t uninit{};
+
+/*
+  Alignment in bytes of the storage of Mat, SymMat and Vec. Define A2D_ALIGN as
+  a power of two (e.g. -DA2D_ALIGN=64) so that each object starts on a cache
+  line. The object size is then padded to a multiple of the alignment, so that
+  objects in an array never straddle cache lines. The default keeps the natural
+  alignment of the numeric type. All translation units must agree on this
+  value, since it changes the size of the objects.
+*/
+#ifndef A2D_ALIGN
+#define A2D_ALIGN 0
+#endif
+
+static_assert((A2D_ALIGN & (A2D_ALIGN - 1)) == 0,
+              "A2D_ALIGN must be zero or a power of two");
+
+template <typename T>
+struct storage_alignment {
+  static constexpr std::size_t value =
+      (A2D_ALIGN > alignof(T) ? std::size_t(A2D_ALIGN) : alignof(T));
+};
+
+/*
+  Tell the compiler that ptr is aligned to Align bytes so that the inlined core
+  kernels can use aligned vector loads and stores
+*/
+template <std::size_t Align, typename T>
+A2D_FUNCTION T* assume_aligned(T* ptr) {
+#if defined(__GNUC__) && !defined(__CUDACC__)
+  return static_cast<T*>(__builtin_assume_aligned(ptr, Align));
+#else
+  return ptr;
+#endif
+}
+
 using index_t = int32_t;
 static constexpr index_t MAX_INDEX = std::numeric_limits<index_t>::max();
 static constexpr index_t INDEX_NBITS = std::numeric_limits<index_t>::digits;
@@ -127,6 +174,20 @@ A2D_FUNCTION inline double ImagPart(A2D_complex_t<double> a) {
   return a.imag();
 }
 
+/*
+  Select between two values based on a condition. For the built-in scalar
+  types the condition is a bool, lane-wise types provide their own overload
+  that takes a mask so that data-dependent branches can be written once.
+*/
+template <typename T>
+A2D_FUNCTION T select(const bool cond, const T& a, const T& b) {
+  return cond ? a : b;
+}
+
+A2D_FUNCTION inline bool any(const bool cond) { return cond; }
+
+A2D_FUNCTION inline bool all(const bool cond) { return cond; }
+
 /*
   Remove the const-ness and references for a type
 */
@@ -152,7 +213,7 @@ struct is_numeric_type
 */
 template <class T>
 struct is_scalar_type {
-  static const bool value =
+  static constexpr bool value =
       is_numeric_type<T>::value || std::is_arithmetic<T>::value;
 };
 
@@ -0,0 +1,411 @@
+#ifndef A2D_SIMD_H
+#define A2D_SIMD_H
+
+#include <type_traits>
+
+#include "a2ddefs.h"
+
+namespace A2D {
+
+/*
+  Alignment of a lane pack: the largest power of two that divides the pack
+  size, capped at 64 bytes (one cache line / one AVX-512 register)
+*/
+template <typename T, int W>
+struct simd_alignment {
+  static constexpr int bytes = int(sizeof(T)) * W;
+  static constexpr int lowbit = bytes & (-bytes);
+  static constexpr int value = (lowbit > 64 ? 64 : lowbit);
+};
+
+/*
+  A fixed-width pack of W lanes of the numeric type T.
+
+  The pack behaves like a scalar: every arithmetic operation is applied
+  lane-wise. When a pack is used as the numeric type of a Mat, SymMat or Vec,
+  the entries are stored lane-interleaved, i.e. lane w of entry k is stored at
+  offset k * W + w. The core kernels then operate on W independent problems at
+  once and the inner lane loops are vectorized by the compiler.
+*/
+template <typename T, int W>
+class alignas(simd_alignment<T, W>::value) simd {
+ public:
+  static_assert(std::is_floating_point<T>::value,
+                "simd lane type must be a floating point type");
+  static_assert(W >= 1, "simd width must be positive");
+
+  using value_type = T;
+  static constexpr int width = W;
+
+  // Left uninitialized, like the built-in numeric types
+  A2D_FUNCTION simd() {}
+
+  // Broadcast a scalar value to all lanes
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd(const R value) {
+    for (int w = 0; w < W; w++) {
+      v[w] = value;
+    }
+  }
+
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd<T, W>& operator=(const R value) {
+    for (int w = 0; w < W; w++) {
+      v[w] = value;
+    }
+    return *this;
+  }
+
+  // Access the lanes
+  template <typename I>
+  A2D_FUNCTION T& operator[](const I w) {
+    return v[w];
+  }
+  template <typename I>
+  A2D_FUNCTION const T& operator[](const I w) const {
+    return v[w];
+  }
+
+  A2D_FUNCTION T* get_data() { return v; }
+  A2D_FUNCTION const T* get_data() const { return v; }
+
+  // Operator +=, -=, *=, /=
+  A2D_FUNCTION simd<T, W>& operator+=(const simd<T, W>& r) {
+    for (int w = 0; w < W; w++) {
+      v[w] += r.v[w];
+    }
+    return *this;
+  }
+  A2D_FUNCTION simd<T, W>& operator-=(const simd<T, W>& r) {
+    for (int w = 0; w < W; w++) {
+      v[w] -= r.v[w];
+    }
+    return *this;
+  }
+  A2D_FUNCTION simd<T, W>& operator*=(const simd<T, W>& r) {
+    for (int w = 0; w < W; w++) {
+      v[w] *= r.v[w];
+    }
+    return *this;
+  }
+  A2D_FUNCTION simd<T, W>& operator/=(const simd<T, W>& r) {
+    for (int w = 0; w < W; w++) {
+      v[w] /= r.v[w];
+    }
+    return *this;
+  }
+
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd<T, W>& operator+=(const R r) {
+    for (int w = 0; w < W; w++) {
+      v[w] += r;
+    }
+    return *this;
+  }
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd<T, W>& operator-=(const R r) {
+    for (int w = 0; w < W; w++) {
+      v[w] -= r;
+    }
+    return *this;
+  }
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd<T, W>& operator*=(const R r) {
+    for (int w = 0; w < W; w++) {
+      v[w] *= r;
+    }
+    return *this;
+  }
+  template <typename R,
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+  A2D_FUNCTION simd<T, W>& operator/=(const R r) {
+    for (int w = 0; w < W; w++) {
+      v[w] /= r;
+    }
+    return *this;
+  }
+
+  A2D_FUNCTION simd<T, W> operator+() const { return *this; }
+  A2D_FUNCTION simd<T, W> operator-() const {
+    simd<T, W> out;
+    for (int w = 0; w < W; w++) {
+      out.v[w] = -v[w];
+    }
+    return out;
+  }
+
+  T v[W];
+};
+
+// Addition, subtraction, multiplication and division
+#define A2D_SIMD_BINARY_OPERATOR(OP)                                      \
+  template <typename T, int W>                                            \
+  A2D_FUNCTION simd<T, W> operator OP(const simd<T, W>& l,                \
+                                      const simd<T, W>& r) {              \
+    simd<T, W> out;                                                       \
+    for (int w = 0; w < W; w++) {                                         \
+      out.v[w] = l.v[w] OP r.v[w];                                        \
+    }                                                                     \
+    return out;                                                           \
+  }                                                                       \
+  template <typename T, int W, typename L,                                \
+            typename = std::enable_if_t<std::is_arithmetic<L>::value>>    \
+  A2D_FUNCTION simd<T, W> operator OP(const L l, const simd<T, W>& r) {   \
+    simd<T, W> out;                                                       \
+    for (int w = 0; w < W; w++) {                                         \
+      out.v[w] = l OP r.v[w];                                             \
+    }                                                                     \
+    return out;                                                           \
+  }                                                                       \
+  template <typename T, int W, typename R,                                \
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>    \
+  A2D_FUNCTION simd<T, W> operator OP(const simd<T, W>& l, const R r) {   \
+    simd<T, W> out;                                                       \
+    for (int w = 0; w < W; w++) {                                         \
+      out.v[w] = l.v[w] OP r;                                             \
+    }                                                                     \
+    return out;                                                           \
+  }
+
+A2D_SIMD_BINARY_OPERATOR(+)
+A2D_SIMD_BINARY_OPERATOR(-)
+A2D_SIMD_BINARY_OPERATOR(*)
+A2D_SIMD_BINARY_OPERATOR(/)
+
+#undef A2D_SIMD_BINARY_OPERATOR
+
+/*
+  Lane mask produced by comparisons of simd values. Branches on values must be
+  written with select(mask, a, b) so that each lane takes its own branch.
+*/
+template <typename T, int W>
+class simd_mask {
+ public:
+  A2D_FUNCTION simd_mask() {}
+  A2D_FUNCTION simd_mask(const bool value) {
+    for (int w = 0; w < W; w++) {
+      m[w] = value;
+    }
+  }
+
+  template <typename I>
+  A2D_FUNCTION bool& operator[](const I w) {
+    return m[w];
+  }
+  template <typename I>
+  A2D_FUNCTION const bool& operator[](const I w) const {
+    return m[w];
+  }
+
+  A2D_FUNCTION simd_mask<T, W> operator!() const {
+    simd_mask<T, W> out;
+    for (int w = 0; w < W; w++) {
+      out.m[w] = !m[w];
+    }
+    return out;
+  }
+
+  bool m[W];
+};
+
+template <typename T, int W>
+A2D_FUNCTION simd_mask<T, W> operator&(const simd_mask<T, W>& l,
+                                       const simd_mask<T, W>& r) {
+  simd_mask<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.m[w] = l.m[w] && r.m[w];
+  }
+  return out;
+}
+
+template <typename T, int W>
+A2D_FUNCTION simd_mask<T, W> operator|(const simd_mask<T, W>& l,
+                                       const simd_mask<T, W>& r) {
+  simd_mask<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.m[w] = l.m[w] || r.m[w];
+  }
+  return out;
+}
+
+// True if the condition holds for any/all lanes
+template <typename T, int W>
+A2D_FUNCTION bool any(const simd_mask<T, W>& mask) {
+  bool value = false;
+  for (int w = 0; w < W; w++) {
+    value = value || mask.m[w];
+  }
+  return value;
+}
+
+template <typename T, int W>
+A2D_FUNCTION bool all(const simd_mask<T, W>& mask) {
+  bool value = true;
+  for (int w = 0; w < W; w++) {
+    value = value && mask.m[w];
+  }
+  return value;
+}
+
+// Comparison operators
+#define A2D_SIMD_COMPARISON_OPERATOR(OP)                                  \
+  template <typename T, int W>                                            \
+  A2D_FUNCTION simd_mask<T, W> operator OP(const simd<T, W>& l,           \
+                                           const simd<T, W>& r) {         \
+    simd_mask<T, W> out;                                                  \
+    for (int w = 0; w < W; w++) {                                         \
+      out.m[w] = l.v[w] OP r.v[w];                                        \
+    }                                                                     \
+    return out;                                                           \
+  }                                                                       \
+  template <typename T, int W, typename L,                                \
+            typename = std::enable_if_t<std::is_arithmetic<L>::value>>    \
+  A2D_FUNCTION simd_mask<T, W> operator OP(const L l,                     \
+                                           const simd<T, W>& r) {         \
+    simd_mask<T, W> out;                                                  \
+    for (int w = 0; w < W; w++) {                                         \
+      out.m[w] = l OP r.v[w];                                             \
+    }                                                                     \
+    return out;                                                           \
+  }                                                                       \
+  template <typename T, int W, typename R,                                \
+            typename = std::enable_if_t<std::is_arithmetic<R>::value>>    \
+  A2D_FUNCTION simd_mask<T, W> operator OP(const simd<T, W>& l,           \
+                                           const R r) {                   \
+    simd_mask<T, W> out;                                                  \
+    for (int w = 0; w < W; w++) {                                         \
+      out.m[w] = l.v[w] OP r;                                             \
+    }                                                                     \
+    return out;                                                           \
+  }
+
+A2D_SIMD_COMPARISON_OPERATOR(<)
+A2D_SIMD_COMPARISON_OPERATOR(<=)
+A2D_SIMD_COMPARISON_OPERATOR(>)
+A2D_SIMD_COMPARISON_OPERATOR(>=)
+A2D_SIMD_COMPARISON_OPERATOR(==)
+A2D_SIMD_COMPARISON_OPERATOR(!=)
+
+#undef A2D_SIMD_COMPARISON_OPERATOR
+
+/*
+  Lane-wise selection: out[w] = mask[w] ? a[w] : b[w]
+*/
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> select(const simd_mask<T, W>& mask,
+                               const simd<T, W>& a, const simd<T, W>& b) {
+  simd<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.v[w] = mask.m[w] ? a.v[w] : b.v[w];
+  }
+  return out;
+}
+
+// The lanes are real-valued
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> RealPart(const simd<T, W>& a) {
+  return a;
+}
+
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> ImagPart(const simd<T, W>& a) {
+  return simd<T, W>(0.0);
+}
+
+// Lane-wise math functions
+#define A2D_SIMD_UNARY_FUNCTION(FUNC)                    \
+  template <typename T, int W>                           \
+  A2D_FUNCTION simd<T, W> FUNC(const simd<T, W>& a) {    \
+    simd<T, W> out;                                      \
+    for (int w = 0; w < W; w++) {                        \
+      out.v[w] = std::FUNC(a.v[w]);                      \
+    }                                                    \
+    return out;                                          \
+  }
+
+A2D_SIMD_UNARY_FUNCTION(fabs)
+A2D_SIMD_UNARY_FUNCTION(sqrt)
+A2D_SIMD_UNARY_FUNCTION(exp)
+A2D_SIMD_UNARY_FUNCTION(log)
+A2D_SIMD_UNARY_FUNCTION(sin)
+A2D_SIMD_UNARY_FUNCTION(asin)
+A2D_SIMD_UNARY_FUNCTION(cos)
+A2D_SIMD_UNARY_FUNCTION(acos)
+A2D_SIMD_UNARY_FUNCTION(atan)
+A2D_SIMD_UNARY_FUNCTION(tanh)
+
+#undef A2D_SIMD_UNARY_FUNCTION
+
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> fsgn(const simd<T, W>& a) {
+  simd<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.v[w] = std::copysign(T(1.0), a.v[w]);
+  }
+  return out;
+}
+
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> absfunc(const simd<T, W>& a) {
+  return fabs(a);
+}
+
+template <typename T, int W, typename R,
+          typename = std::enable_if_t<std::is_arithmetic<R>::value>>
+A2D_FUNCTION simd<T, W> pow(const simd<T, W>& a, const R exponent) {
+  simd<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.v[w] = std::pow(a.v[w], exponent);
+  }
+  return out;
+}
+
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> pow(const simd<T, W>& a, const simd<T, W>& exponent) {
+  simd<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.v[w] = std::pow(a.v[w], exponent.v[w]);
+  }
+  return out;
+}
+
+template <typename T, int W>
+A2D_FUNCTION simd<T, W> atan2(const simd<T, W>& y, const simd<T, W>& x) {
+  simd<T, W> out;
+  for (int w = 0; w < W; w++) {
+    out.v[w] = std::atan2(y.v[w], x.v[w]);
+  }
+  return out;
+}
+
+/*
+  Type traits so that simd<T, W> is treated as a scalar numeric type by the
+  A2D objects and expressions
+*/
+template <typename T>
+struct is_simd : public std::false_type {};
+
+template <typename T, int W>
+struct is_simd<simd<T, W>> : public std::true_type {};
+
+template <typename T, int W>
+struct __is_numeric_type<simd<T, W>> : std::is_floating_point<T> {};
+
+template <typename T, int W>
+struct __get_object_numeric_type<simd<T, W>> {
+  using type = simd<T, W>;
+};
+
+template <typename T, int W>
+struct __get_a2d_object_type<simd<T, W>> {
+  static constexpr ADObjType value = ADObjType::SCALAR;
+};
+
+}  // namespace A2D
+
+#endif  // A2D_SIMD_H
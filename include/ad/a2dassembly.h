@@ -0,0 +1,803 @@
+#ifndef A2D_ASSEMBLY_H
+#define A2D_ASSEMBLY_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../a2ddefs.h"
+#include "a2dbatch.h"
+#include "a2dmat.h"
+#include "a2dsparse.h"
+#include "a2dvec.h"
+
+namespace A2D {
+
+/**
+ * @brief Fork-join pool of worker threads
+ *
+ * run(func) calls func(thread_id) once on every thread and returns when all
+ * of the calls are done. The calling thread takes part as thread 0, so a pool
+ * with one thread starts no workers. The threads are kept between calls.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param num_threads Number of threads, 0 for the hardware concurrency
+   */
+  explicit ThreadPool(index_t num_threads = 0)
+      : num_threads(num_threads > 0
+                        ? num_threads
+                        : std::max<index_t>(
+                              1, std::thread::hardware_concurrency())),
+        generation(0),
+        num_done(0),
+        stop(false),
+        barrier_count(0),
+        barrier_generation(0) {
+    for (index_t i = 1; i < this->num_threads; i++) {
+      workers.emplace_back(&ThreadPool::worker, this, i);
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    start_cv.notify_all();
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+  index_t get_num_threads() const { return num_threads; }
+
+  // Call func(thread_id) on every thread and wait for all of them. The
+  // function must not throw.
+  template <class Func>
+  void run(Func&& func) {
+    if (num_threads == 1) {
+      func(index_t(0));
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      task = [&func](index_t id) { func(id); };
+      num_done = 0;
+      generation++;
+    }
+    start_cv.notify_all();
+
+    func(index_t(0));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this] { return num_done == num_threads - 1; });
+    task = nullptr;
+  }
+
+  // Wait until all the threads of the current run() reach the barrier
+  void barrier() {
+    if (num_threads == 1) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(barrier_mutex);
+    index_t gen = barrier_generation;
+    if (++barrier_count == num_threads) {
+      barrier_count = 0;
+      barrier_generation++;
+      barrier_cv.notify_all();
+    } else {
+      barrier_cv.wait(lock, [&] { return gen != barrier_generation; });
+    }
+  }
+
+ private:
+  void worker(index_t id) {
+    index_t gen = 0;
+    while (true) {
+      std::function<void(index_t)>* func;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start_cv.wait(lock, [&] { return stop || generation != gen; });
+        if (stop) {
+          return;
+        }
+        gen = generation;
+        func = &task;
+      }
+
+      (*func)(id);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        num_done++;
+      }
+      done_cv.notify_one();
+    }
+  }
+
+  const index_t num_threads;
+  std::vector<std::thread> workers;
+
+  // State of the current run()
+  std::mutex mutex;
+  std::condition_variable start_cv, done_cv;
+  std::function<void(index_t)> task;
+  index_t generation, num_done;
+  bool stop;
+
+  // State of the barrier
+  std::mutex barrier_mutex;
+  std::condition_variable barrier_cv;
+  index_t barrier_count, barrier_generation;
+};
+
+/**
+ * @brief Load-balance statistics of one worker of a WorkStealingScheduler
+ *
+ * The idle time is the time spent in for_each() outside of the user function:
+ * looking for work, stealing and waiting for the other workers to finish.
+ */
+struct WorkerStats {
+  index_t num_items = 0;   // Number of items processed
+  index_t num_chunks = 0;  // Number of chunks processed
+  index_t num_steals = 0;  // Number of successful steals
+  double busy_time = 0.0;  // Seconds spent in the user function
+  double idle_time = 0.0;  // Seconds spent without work
+};
+
+/**
+ * @brief Work-stealing scheduler of index ranges on a ThreadPool
+ *
+ * The range [0, n) is cut into chunks of chunk_size items and each worker
+ * starts with an even share of the chunks in its own deque. A worker takes
+ * chunks from the front of its deque and, when the deque is empty, steals the
+ * back half of the chunks of another worker into its own deque. This keeps
+ * the workers busy when the cost of the items varies, for instance for a mesh
+ * that mixes cheap and expensive element stacks.
+ */
+class WorkStealingScheduler {
+ public:
+  /**
+   * @param pool Thread pool whose threads run the loops
+   * @param chunk_size Number of items taken at a time
+   */
+  explicit WorkStealingScheduler(ThreadPool& pool, index_t chunk_size = 8)
+      : pool(pool),
+        chunk_size(std::max<index_t>(1, chunk_size)),
+        deques(new Deque[pool.get_num_threads()]),
+        stats(pool.get_num_threads()) {}
+
+  ThreadPool& get_pool() { return pool; }
+  index_t get_chunk_size() const { return chunk_size; }
+
+  /**
+   * @brief Call func(i) for every i in [0, n)
+   *
+   * This must be called by all the threads of a ThreadPool::run() with the
+   * same n. It returns on every thread once all the items are done.
+   *
+   * @param id Thread index
+   * @param n Number of items
+   * @param func Callable func(i) for the item i
+   */
+  template <class Func>
+  void for_each(index_t id, index_t n, const Func& func) {
+    using clock = std::chrono::steady_clock;
+    const index_t num_threads = pool.get_num_threads();
+    const index_t num_chunks = (n + chunk_size - 1) / chunk_size;
+    auto start = clock::now();
+
+    {
+      std::lock_guard<std::mutex> lock(deques[id].mutex);
+      deques[id].front = (int64_t(num_chunks) * id) / num_threads;
+      deques[id].back = (int64_t(num_chunks) * (id + 1)) / num_threads;
+    }
+    pool.barrier();
+
+    WorkerStats local;
+    while (true) {
+      index_t chunk;
+      if (pop(id, chunk)) {
+        auto t = clock::now();
+        index_t end = std::min(n, chunk_size * (chunk + 1));
+        for (index_t i = chunk_size * chunk; i < end; i++) {
+          func(i);
+        }
+        local.busy_time +=
+            std::chrono::duration<double>(clock::now() - t).count();
+        local.num_items += end - chunk_size * chunk;
+        local.num_chunks++;
+      } else if (steal(id)) {
+        local.num_steals++;
+      } else {
+        break;
+      }
+    }
+    pool.barrier();
+
+    double total = std::chrono::duration<double>(clock::now() - start).count();
+    stats[id].num_items += local.num_items;
+    stats[id].num_chunks += local.num_chunks;
+    stats[id].num_steals += local.num_steals;
+    stats[id].busy_time += local.busy_time;
+    stats[id].idle_time += total - local.busy_time;
+  }
+
+  // Call func(id, i) for every i in [0, n) on the threads of the pool
+  template <class Func>
+  void parallel_for(index_t n, const Func& func) {
+    pool.run([&](index_t id) {
+      for_each(id, n, [&](index_t i) { func(id, i); });
+    });
+  }
+
+  // Statistics of each worker accumulated since the last reset
+  const std::vector<WorkerStats>& get_stats() const { return stats; }
+  void reset_stats() { stats.assign(stats.size(), WorkerStats()); }
+
+ private:
+  // Chunks [front, back) left to a worker
+  struct alignas(64) Deque {
+    std::mutex mutex;
+    index_t front = 0, back = 0;
+  };
+
+  // Take the next chunk of the worker's own deque
+  bool pop(index_t id, index_t& chunk) {
+    std::lock_guard<std::mutex> lock(deques[id].mutex);
+    if (deques[id].front < deques[id].back) {
+      chunk = deques[id].front++;
+      return true;
+    }
+    return false;
+  }
+
+  // Move the back half of the chunks of another worker into the worker's
+  // own, empty, deque
+  bool steal(index_t id) {
+    const index_t num_threads = pool.get_num_threads();
+    for (index_t k = 1; k < num_threads; k++) {
+      Deque& victim = deques[(id + k) % num_threads];
+      index_t front, back;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        index_t size = victim.back - victim.front;
+        if (size == 0) {
+          continue;
+        }
+        back = victim.back;
+        front = back - (size + 1) / 2;
+        victim.back = front;
+      }
+
+      std::lock_guard<std::mutex> lock(deques[id].mutex);
+      deques[id].front = front;
+      deques[id].back = back;
+      return true;
+    }
+    return false;
+  }
+
+  ThreadPool& pool;
+  const index_t chunk_size;
+  std::unique_ptr<Deque[]> deques;
+  std::vector<WorkerStats> stats;
+};
+
+/**
+ * @brief Greedy coloring of the elements of a mesh
+ *
+ * Elements of the same color share no node, so they can add to the global
+ * residual and Jacobian at the same time without atomics or locks.
+ */
+class ElementColoring {
+ public:
+  /**
+   * @param nelems Number of elements
+   * @param nodes_per_elem Number of nodes of each element
+   * @param conn Element connectivity, nodes_per_elem nodes per element
+   */
+  ElementColoring(index_t nelems, index_t nodes_per_elem, const index_t conn[])
+      : num_colors(0), color_ptr(1, 0), elems(nelems) {
+    index_t nnodes = 0;
+    for (index_t i = 0; i < nelems * nodes_per_elem; i++) {
+      nnodes = std::max(nnodes, conn[i] + 1);
+    }
+
+    // Elements that contain each node
+    std::vector<index_t> node_ptr(nnodes + 1, 0);
+    for (index_t i = 0; i < nelems * nodes_per_elem; i++) {
+      node_ptr[conn[i] + 1]++;
+    }
+    for (index_t n = 0; n < nnodes; n++) {
+      node_ptr[n + 1] += node_ptr[n];
+    }
+    std::vector<index_t> node_elems(node_ptr[nnodes]);
+    std::vector<index_t> pos(node_ptr.begin(), node_ptr.end() - 1);
+    for (index_t e = 0; e < nelems; e++) {
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        node_elems[pos[conn[nodes_per_elem * e + j]]++] = e;
+      }
+    }
+
+    // Give each element the smallest color not used by an earlier element
+    // that shares a node with it
+    std::vector<index_t> color(nelems, NO_INDEX);
+    std::vector<index_t> mark;
+    for (index_t e = 0; e < nelems; e++) {
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        index_t n = conn[nodes_per_elem * e + j];
+        for (index_t k = node_ptr[n]; k < node_ptr[n + 1]; k++) {
+          index_t c = color[node_elems[k]];
+          if (c != NO_INDEX) {
+            mark[c] = e;
+          }
+        }
+      }
+
+      index_t c = 0;
+      while (c < num_colors && mark[c] == e) {
+        c++;
+      }
+      if (c == num_colors) {
+        num_colors++;
+        mark.push_back(NO_INDEX);
+      }
+      color[e] = c;
+    }
+
+    // Order the elements by color
+    color_ptr.assign(num_colors + 1, 0);
+    for (index_t e = 0; e < nelems; e++) {
+      color_ptr[color[e] + 1]++;
+    }
+    for (index_t c = 0; c < num_colors; c++) {
+      color_ptr[c + 1] += color_ptr[c];
+    }
+    pos.assign(color_ptr.begin(), color_ptr.end() - 1);
+    for (index_t e = 0; e < nelems; e++) {
+      elems[pos[color[e]]++] = e;
+    }
+  }
+
+  index_t get_num_colors() const { return num_colors; }
+
+  // Get the elements of color c
+  index_t get_elements(index_t c, const index_t* elements[]) const {
+    *elements = &elems[color_ptr[c]];
+    return color_ptr[c + 1] - color_ptr[c];
+  }
+
+ private:
+  index_t num_colors;
+  std::vector<index_t> color_ptr;  // Offsets of each color into elems
+  std::vector<index_t> elems;      // Elements ordered by color
+};
+
+/**
+ * @brief Parallel element loop that adds element residuals and Jacobians
+ * into global arrays
+ *
+ * The element computations are done by a kernel on a ThreadPool. Each
+ * thread makes its own local state, for instance a StackPlan with the
+ * element objects, by calling make_local() once per loop, so the A2D objects
+ * and stacks are never shared between threads. The elements are visited by
+ * color with a barrier between colors, so the additions to the global arrays
+ * need no atomics.
+ *
+ * By default the elements of each color are split evenly between the
+ * threads. With set_scheduler(), they are distributed by a
+ * WorkStealingScheduler on the same pool instead, which balances elements of
+ * different cost.
+ *
+ * The global degrees of freedom are numbered vars_per_node * node + var and
+ * the element degrees of freedom vars_per_node * j + var for the j-th node of
+ * the element.
+ *
+ * @tparam T Scalar type
+ * @tparam nodes_per_elem Number of nodes of each element
+ * @tparam vars_per_node Number of variables at each node
+ */
+template <typename T, index_t nodes_per_elem, index_t vars_per_node>
+class ElementAssembler {
+ public:
+  static constexpr index_t ndof = nodes_per_elem * vars_per_node;
+  using ElemVec = Vec<T, ndof>;
+  using ElemMat = Mat<T, ndof, ndof>;
+
+  /**
+   * @param nelems Number of elements
+   * @param conn Element connectivity, copied by the assembler
+   * @param pool Thread pool used for the element loops
+   */
+  ElementAssembler(index_t nelems, const index_t conn[], ThreadPool& pool)
+      : nelems(nelems),
+        nnodes(0),
+        conn(conn, conn + nelems * nodes_per_elem),
+        pool(pool),
+        scheduler(nullptr),
+        coloring(nelems, nodes_per_elem, conn) {
+    for (index_t i = 0; i < nelems * nodes_per_elem; i++) {
+      nnodes = std::max(nnodes, conn[i] + 1);
+    }
+  }
+
+  index_t get_num_elements() const { return nelems; }
+  index_t get_num_nodes() const { return nnodes; }
+  index_t get_num_dof() const { return vars_per_node * nnodes; }
+  const ElementColoring& get_coloring() const { return coloring; }
+
+  // Distribute the elements with a work-stealing scheduler on the same pool,
+  // or evenly when scheduler is nullptr
+  void set_scheduler(WorkStealingScheduler* scheduler) {
+    this->scheduler = scheduler;
+  }
+
+  // Get the nodes of an element
+  const index_t* get_element_nodes(index_t elem) const {
+    return &conn[nodes_per_elem * elem];
+  }
+
+  // Copy the element entries of the global vector x into xe
+  template <class ElemVecType>
+  void gather(index_t elem, const T x[], ElemVecType& xe) const {
+    const index_t* nodes = get_element_nodes(elem);
+    for (index_t j = 0; j < nodes_per_elem; j++) {
+      for (index_t k = 0; k < vars_per_node; k++) {
+        xe[vars_per_node * j + k] = x[vars_per_node * nodes[j] + k];
+      }
+    }
+  }
+
+  // Add the element vector re into the global vector r
+  template <class ElemVecType>
+  void scatter_add(index_t elem, const ElemVecType& re, T r[]) const {
+    const index_t* nodes = get_element_nodes(elem);
+    for (index_t j = 0; j < nodes_per_elem; j++) {
+      for (index_t k = 0; k < vars_per_node; k++) {
+        r[vars_per_node * nodes[j] + k] += re[vars_per_node * j + k];
+      }
+    }
+  }
+
+  // Copy the element entries of x for elems[0], ..., elems[count - 1] into
+  // the lanes of xe. The lanes past count get the entries of elems[0], so that
+  // every lane holds valid values.
+  template <class ElemVecType>
+  void gather_lanes(const index_t elems[], index_t count, const T x[],
+                    ElemVecType& xe) const {
+    constexpr index_t K = get_batch_width<typename ElemVecType::type>::width;
+    for (index_t lane = 0; lane < K; lane++) {
+      const index_t* nodes = get_element_nodes(elems[lane < count ? lane : 0]);
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        for (index_t k = 0; k < vars_per_node; k++) {
+          xe[vars_per_node * j + k][lane] = x[vars_per_node * nodes[j] + k];
+        }
+      }
+    }
+  }
+
+  // Add the lanes of re for elems[0], ..., elems[count - 1] into r
+  template <class ElemVecType>
+  void scatter_add_lanes(const index_t elems[], index_t count,
+                         const ElemVecType& re, T r[]) const {
+    for (index_t lane = 0; lane < count; lane++) {
+      const index_t* nodes = get_element_nodes(elems[lane]);
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        for (index_t k = 0; k < vars_per_node; k++) {
+          r[vars_per_node * nodes[j] + k] += re[vars_per_node * j + k][lane];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Add the element residuals to the global residual
+   *
+   * @param make_local Callable that returns the local state of a thread
+   * @param kernel Callable kernel(local, elem, re) that computes the
+   * residual re of element elem
+   * @param res Global residual
+   */
+  template <class MakeLocal, class Kernel>
+  void add_residual(const MakeLocal& make_local, const Kernel& kernel,
+                    T res[]) {
+    colored_loop(make_local, [&](auto& local, index_t elem) {
+      ElemVec re;
+      kernel(local, elem, re);
+      scatter_add(elem, re, res);
+    });
+  }
+
+  /**
+   * @brief Add the element residuals and Jacobians to the global residual
+   * and the global Jacobian
+   *
+   * @param make_local Callable that returns the local state of a thread
+   * @param kernel Callable kernel(local, elem, re, ke) that computes the
+   * residual re and the Jacobian ke of element elem
+   * @param res Global residual
+   * @param jac Dense row-major global Jacobian with get_num_dof() rows, or a
+   * BSRMat<T, vars_per_node> built from the same connectivity
+   */
+  template <class MakeLocal, class Kernel, class JacType>
+  void add_jacobian(const MakeLocal& make_local, const Kernel& kernel, T res[],
+                    JacType&& jac) {
+    colored_loop(make_local, [&](auto& local, index_t elem) {
+      ElemVec re;
+      ElemMat ke;
+      kernel(local, elem, re, ke);
+      scatter_add(elem, re, res);
+      add_element_jacobian(elem, ke, jac);
+    });
+  }
+
+  /**
+   * @brief Add the element residuals and Jacobians with atomic additions
+   *
+   * The elements are not colored: each thread takes a share of all the
+   * elements, or its chunks from the scheduler, and adds the residual and
+   * the Jacobian entries with compare-and-swap loops. This avoids the
+   * barriers between colors, at the cost of the atomic additions.
+   *
+   * @param make_local Callable that returns the local state of a thread
+   * @param kernel Callable kernel(local, elem, re, ke) that computes the
+   * residual re and the Jacobian ke of element elem
+   * @param res Global residual
+   * @param jac BSRMat<T, vars_per_node> built from the same connectivity
+   */
+  template <class MakeLocal, class Kernel>
+  void add_jacobian_atomic(const MakeLocal& make_local, const Kernel& kernel,
+                           T res[], BSRMat<T, vars_per_node>& jac) {
+    uncolored_loop(make_local, [&](auto& local, index_t elem) {
+      ElemVec re;
+      ElemMat ke;
+      kernel(local, elem, re, ke);
+
+      const index_t* nodes = get_element_nodes(elem);
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        for (index_t k = 0; k < vars_per_node; k++) {
+          atomic_add(res[vars_per_node * nodes[j] + k],
+                     re[vars_per_node * j + k]);
+        }
+      }
+      jac.add_element_atomic(elem, ke);
+    });
+  }
+
+  /**
+   * @brief Add the element residuals and Jacobians with the columns of each
+   * element Jacobian split between the threads
+   *
+   * The elements are done one after the other. Each thread computes the
+   * columns [begin, end) of the element Jacobian with its own local state, for
+   * instance with OperationStack::hextract_range(), so the threads share no
+   * seeds. This suits a few elements with many degrees of freedom, where
+   * the element loop alone has too little parallelism. Each thread repeats
+   * the eval() and reverse() of the element, which is small next to the
+   * ndof / num_threads Hessian-vector products.
+   *
+   * @param make_local Callable that returns the local state of a thread
+   * @param kernel Callable kernel(local, elem, re, ke, begin, end) that
+   * computes the residual re and the columns [begin, end) of the Jacobian ke
+   * of element elem
+   * @param res Global residual
+   * @param jac Dense row-major global Jacobian with get_num_dof() rows, or a
+   * BSRMat<T, vars_per_node> built from the same connectivity
+   */
+  template <class MakeLocal, class Kernel, class JacType>
+  void add_jacobian_by_columns(const MakeLocal& make_local,
+                               const Kernel& kernel, T res[], JacType&& jac) {
+    const index_t num_threads = pool.get_num_threads();
+
+    // Thread 0 adds the element e - 1 while the others compute element e,
+    // so the element residual and Jacobian alternate between two buffers
+    std::vector<ElemVec> re(2);
+    std::vector<ElemMat> ke(2);
+
+    pool.run([&](index_t id) {
+      auto local = make_local();
+      ElemVec re_local;
+
+      index_t begin = (ndof * id) / num_threads;
+      index_t end = (ndof * (id + 1)) / num_threads;
+      for (index_t elem = 0; elem < nelems; elem++) {
+        index_t b = elem % 2;
+        kernel(local, elem, id == 0 ? re[b] : re_local, ke[b], begin, end);
+        pool.barrier();
+
+        if (id == 0) {
+          scatter_add(elem, re[b], res);
+          add_element_jacobian(elem, ke[b], jac);
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Add the product of the global Jacobian with p to y without
+   * assembling the Jacobian
+   *
+   * The elements of each color are taken K at a time. The entries of p for
+   * the K elements are gathered into the lanes of pe, the kernel computes
+   * the K element products ye = Ke * pe at once with a stack built with the
+   * lane type simd<T, K>, for instance with hproduct() or JacobianProduct(),
+   * and the lanes of ye are added to y.
+   *
+   * @tparam K Number of elements per kernel call (the lane width)
+   * @param make_local Callable that returns the local state of a thread
+   * @param kernel Callable kernel(local, elems, count, pe, ye) that computes
+   * the products of the elements elems[0], ..., elems[count - 1], with
+   * count <= K. The lanes past count must hold valid values, which
+   * gather_lanes() ensures.
+   * @param p Global direction
+   * @param y Global product
+   */
+  template <index_t K, class MakeLocal, class Kernel>
+  void add_jacobian_product(const MakeLocal& make_local, const Kernel& kernel,
+                            const T p[], T y[]) {
+    using ElemVecK = Vec<simd<T, K>, ndof>;
+    colored_batch_loop<K>(
+        make_local, [&](auto& local, const index_t* elems, index_t count) {
+          ElemVecK pe, ye;
+          gather_lanes(elems, count, p, pe);
+          kernel(local, elems, count, pe, ye);
+          scatter_add_lanes(elems, count, ye, y);
+        });
+  }
+
+ private:
+  // Add the element Jacobian ke into the global Jacobian
+  void add_element_jacobian(index_t elem, const ElemMat& ke,
+                            BSRMat<T, vars_per_node>& jac) const {
+    jac.add_element(elem, ke);
+  }
+  void add_element_jacobian(index_t elem, const ElemMat& ke, T jac[]) const {
+    const index_t n = get_num_dof();
+    const index_t* nodes = get_element_nodes(elem);
+    for (index_t i = 0; i < ndof; i++) {
+      index_t row =
+          vars_per_node * nodes[i / vars_per_node] + i % vars_per_node;
+      for (index_t j = 0; j < ndof; j++) {
+        index_t col =
+            vars_per_node * nodes[j / vars_per_node] + j % vars_per_node;
+        jac[n * row + col] += ke(i, j);
+      }
+    }
+  }
+
+  // Call func(local, elem) for all the elements, one color at a time, with
+  // the elements of each color split evenly between the threads or by the
+  // scheduler
+  template <class MakeLocal, class Func>
+  void colored_loop(const MakeLocal& make_local, const Func& func) {
+    colored_batch_loop<1>(
+        make_local, [&](auto& local, const index_t* elems, index_t count) {
+          func(local, elems[0]);
+        });
+  }
+
+  // Call func(local, elems, count) for all the elements, one color at a
+  // time, with count <= K consecutive elements of the same color per call
+  template <index_t K, class MakeLocal, class Func>
+  void colored_batch_loop(const MakeLocal& make_local, const Func& func) {
+    const index_t num_threads = pool.get_num_threads();
+    pool.run([&](index_t id) {
+      auto local = make_local();
+
+      for (index_t c = 0; c < coloring.get_num_colors(); c++) {
+        const index_t* elements;
+        index_t size = coloring.get_elements(c, &elements);
+        index_t num_batches = (size + K - 1) / K;
+        auto batch = [&](index_t i) {
+          func(local, &elements[K * i], std::min(K, size - K * i));
+        };
+
+        if (scheduler) {
+          scheduler->for_each(id, num_batches, batch);
+          continue;
+        }
+
+        index_t start = (int64_t(num_batches) * id) / num_threads;
+        index_t end = (int64_t(num_batches) * (id + 1)) / num_threads;
+        for (index_t i = start; i < end; i++) {
+          batch(i);
+        }
+        pool.barrier();
+      }
+    });
+  }
+
+  // Call func(local, elem) for all the elements in any order, with the
+  // elements split evenly between the threads or by the scheduler
+  template <class MakeLocal, class Func>
+  void uncolored_loop(const MakeLocal& make_local, const Func& func) {
+    const index_t num_threads = pool.get_num_threads();
+    pool.run([&](index_t id) {
+      auto local = make_local();
+      if (scheduler) {
+        scheduler->for_each(id, nelems,
+                            [&](index_t elem) { func(local, elem); });
+        return;
+      }
+
+      index_t start = (int64_t(nelems) * id) / num_threads;
+      index_t end = (int64_t(nelems) * (id + 1)) / num_threads;
+      for (index_t elem = start; elem < end; elem++) {
+        func(local, elem);
+      }
+    });
+  }
+
+  const index_t nelems;
+  index_t nnodes;
+  std::vector<index_t> conn;
+  ThreadPool& pool;
+  WorkStealingScheduler* scheduler;
+  ElementColoring coloring;
+};
+
+/**
+ * @brief Matrix-free global Jacobian for iterative solvers
+ *
+ * mult(x, y) computes y = J * x with ElementAssembler::add_jacobian_product,
+ * recomputing the element products at every call instead of storing the
+ * Jacobian. It has the same const mult() as BSRMat, so the two can be swapped
+ * in a Krylov solver. The assembler is held by pointer since
+ * add_jacobian_product() is not const.
+ *
+ * @tparam K Number of elements per kernel call (the lane width)
+ */
+template <index_t K, class Assembler, class MakeLocal, class Kernel>
+class MatrixFreeJacobian {
+ public:
+  using T = typename Assembler::ElemVec::type;
+
+  MatrixFreeJacobian(Assembler& assembler, const MakeLocal& make_local,
+                     const Kernel& kernel)
+      : assembler(&assembler), make_local(make_local), kernel(kernel) {}
+
+  index_t get_num_rows() const { return assembler->get_num_dof(); }
+
+  // Compute y = J * x
+  void mult(const T x[], T y[]) const {
+    std::fill(y, y + get_num_rows(), T(0.0));
+    assembler->template add_jacobian_product<K>(make_local, kernel, x, y);
+  }
+
+ private:
+  Assembler* assembler;
+  MakeLocal make_local;
+  Kernel kernel;
+};
+
+/**
+ * @brief Make a matrix-free global Jacobian
+ *
+ * @tparam K Number of elements per kernel call (the lane width)
+ * @param assembler Element assembler of the mesh
+ * @param make_local Callable that returns the local state of a thread
+ * @param kernel Element product kernel of add_jacobian_product()
+ * @return The matrix-free Jacobian
+ */
+template <index_t K, class Assembler, class MakeLocal, class Kernel>
+auto MakeMatrixFreeJacobian(Assembler& assembler, const MakeLocal& make_local,
+                            const Kernel& kernel) {
+  return MatrixFreeJacobian<K, Assembler, MakeLocal, Kernel>(
+      assembler, make_local, kernel);
+}
+
+}  // namespace A2D
+
+#endif  // A2D_ASSEMBLY_H
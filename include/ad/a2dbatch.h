@@ -0,0 +1,120 @@
+#ifndef A2D_BATCH_H
+#define A2D_BATCH_H
+
+#include "../a2ddefs.h"
+#include "../a2dsimd.h"
+#include "a2dmat.h"
+#include "a2dvec.h"
+
+namespace A2D {
+
+/*
+  Batched containers: W independent matrices/vectors stored lane-interleaved.
+
+  Entry k of lane w is stored at offset k * W + w of the underlying data, so
+  that each core kernel processes W problems (for instance W quadrature points
+  or W elements) per call. The batched types are regular Mat, SymMat and Vec
+  objects whose numeric type is simd<T, W>, so they can be used directly with
+  ADObj, A2DObj, the expressions and the OperationStack.
+*/
+template <typename T, int M, int N, int W>
+using MatBatch = Mat<simd<T, W>, M, N>;
+
+template <typename T, int N, int W>
+using SymMatBatch = SymMat<simd<T, W>, N>;
+
+template <typename T, int N, int W>
+using VecBatch = Vec<simd<T, W>, N>;
+
+/*
+  Get the number of lanes of a batched object
+*/
+template <class T>
+struct get_batch_width {
+  static constexpr int width = 1;
+};
+
+template <typename T, int W>
+struct get_batch_width<simd<T, W>> {
+  static constexpr int width = W;
+};
+
+/**
+ * @brief Copy the object into lane of the batched object
+ *
+ * @param obj The scalar-valued Mat, SymMat or Vec
+ * @param lane The lane index
+ * @param batch The batched object with the same shape
+ */
+template <class Obj, class BatchObj>
+A2D_FUNCTION void BatchSetLane(const Obj& obj, const index_t lane,
+                               BatchObj& batch) {
+  static_assert(Obj::obj_type == BatchObj::obj_type &&
+                    Obj::ncomp == BatchObj::ncomp,
+                "Batched object must have the same shape as the object");
+  for (index_t i = 0; i < Obj::ncomp; i++) {
+    batch[i][lane] = obj[i];
+  }
+}
+
+/**
+ * @brief Copy a lane of the batched object into the object
+ *
+ * @param batch The batched object
+ * @param lane The lane index
+ * @param obj The scalar-valued Mat, SymMat or Vec with the same shape
+ */
+template <class BatchObj, class Obj>
+A2D_FUNCTION void BatchGetLane(const BatchObj& batch, const index_t lane,
+                               Obj& obj) {
+  static_assert(Obj::obj_type == BatchObj::obj_type &&
+                    Obj::ncomp == BatchObj::ncomp,
+                "Batched object must have the same shape as the object");
+  for (index_t i = 0; i < Obj::ncomp; i++) {
+    obj[i] = batch[i][lane];
+  }
+}
+
+/**
+ * @brief Gather an array of objects into the lanes of a batched object
+ *
+ * Only the first n lanes are set, the remaining lanes are set to zero
+ *
+ * @param n The number of objects (n <= W)
+ * @param objs The array of objects
+ * @param batch The batched object
+ */
+template <class Obj, class BatchObj>
+A2D_FUNCTION void BatchGather(const index_t n, const Obj objs[],
+                              BatchObj& batch) {
+  constexpr int W = get_batch_width<typename BatchObj::type>::width;
+  for (index_t i = 0; i < Obj::ncomp; i++) {
+    for (index_t w = 0; w < n; w++) {
+      batch[i][w] = objs[w][i];
+    }
+    for (index_t w = n; w < W; w++) {
+      batch[i][w] = 0.0;
+    }
+  }
+}
+
+/**
+ * @brief Scatter the first n lanes of a batched object to an array of objects
+ *
+ * @param batch The batched object
+ * @param n The number of objects (n <= W)
+ * @param objs The array of objects
+ */
+template <class BatchObj, class Obj>
+A2D_FUNCTION void BatchScatter(const BatchObj& batch, const index_t n,
+                               Obj objs[]) {
+  for (index_t w = 0; w < n; w++) {
+    for (index_t i = 0; i < Obj::ncomp; i++) {
+      objs[w][i] = batch[i][w];
+    }
+  }
+}
+
+}  // namespace A2D
+
+#endif  // A2D_BATCH_H
@@ -7,18 +7,12 @@ namespace A2D {
 
 template <typename T, std::enable_if_t<is_scalar_type<T>::value, bool> = true>
 A2D_FUNCTION T max2(const T a, const T b) {
-  if (RealPart(a) > RealPart(b)) {
-    return a;
-  }
-  return b;
+  return select(RealPart(a) > RealPart(b), a, b);
 }
 
 template <typename T, std::enable_if_t<is_scalar_type<T>::value, bool> = true>
 A2D_FUNCTION T min2(const T a, const T b) {
-  if (RealPart(a) < RealPart(b)) {
-    return a;
-  }
-  return b;
+  return select(RealPart(a) < RealPart(b), a, b);
 }
 
 #define A2D_1ST_BINARY_BASIC(OBJNAME, OPERNAME, FUNCBODY, FORWARDBODY,       \
@@ -184,15 +178,17 @@ A2D_1ST_BINARY(Divide, operator/, a.value() / b.value(), T(1.0) / b.value(),
                tmp*(a.bvalue() - tmp * a.value() * b.bvalue()), tmp* bval,
                -tmp* tmp* a.value() * bval)
 A2D_1ST_BINARY(Max, max2,
-               (RealPart(a.value()) > RealPart(b.value()) ? a.value()
-                                                          : b.value()),
-               (RealPart(a.value()) > RealPart(b.value()) ? T(1.0) : T(0.0)),
+               select(RealPart(a.value()) > RealPart(b.value()), a.value(),
+                      b.value()),
+               select(RealPart(a.value()) > RealPart(b.value()), T(1.0),
+                      T(0.0)),
                tmp* a.bvalue() + (1.0 - tmp) * b.value(), tmp* bval,
                (1.0 - tmp) * bval)
 A2D_1ST_BINARY(Min, min2,
-               (RealPart(a.value()) < RealPart(b.value()) ? a.value()
-                                                          : b.value()),
-               (RealPart(a.value()) < RealPart(b.value()) ? T(1.0) : T(0.0)),
+               select(RealPart(a.value()) < RealPart(b.value()), a.value(),
+                      b.value()),
+               select(RealPart(a.value()) < RealPart(b.value()), T(1.0),
+                      T(0.0)),
                tmp* a.bvalue() + (1.0 - tmp) * b.value(), tmp* bval,
                (1.0 - tmp) * bval)
 
@@ -405,16 +401,18 @@ A2D_2ND_BINARY(Divide2, operator/, a.value() / b.value(), T(1.0) / b.value(),
                tmp* tmp * (2.0 * tmp * a.value() * bval * b.pvalue() -
                            a.value() * hval - bval * a.pvalue()))
 A2D_2ND_BINARY(Max2, max2,
-               (RealPart(a.value()) > RealPart(b.value()) ? a.value()
-                                                          : b.value()),
-               (RealPart(a.value()) > RealPart(b.value()) ? T(1.0) : T(0.0)),
+               select(RealPart(a.value()) > RealPart(b.value()), a.value(),
+                      b.value()),
+               select(RealPart(a.value()) > RealPart(b.value()), T(1.0),
+                      T(0.0)),
                tmp* bval, (1.0 - tmp) * bval,
                tmp* a.bvalue() + (1.0 - tmp) * b.value(), tmp* hval,
                (1.0 - tmp) * hval)
 A2D_2ND_BINARY(Min2, min2,
-               (RealPart(a.value()) < RealPart(b.value()) ? a.value()
-                                                          : b.value()),
-               (RealPart(a.value()) < RealPart(b.value()) ? T(1.0) : T(0.0)),
+               select(RealPart(a.value()) < RealPart(b.value()), a.value(),
+                      b.value()),
+               select(RealPart(a.value()) < RealPart(b.value()), T(1.0),
+                      T(0.0)),
                tmp* bval, (1.0 - tmp) * bval,
                tmp* a.bvalue() + (1.0 - tmp) * b.value(), tmp* hval,
                (1.0 - tmp) * hval)
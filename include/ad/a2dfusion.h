@@ -0,0 +1,133 @@
+#ifndef A2D_FUSION_H
+#define A2D_FUSION_H
+
+#include <type_traits>
+
+#include "../a2ddefs.h"
+#include "a2disotropic.h"
+#include "a2dstack.h"
+#include "a2dsymmatmulttrace.h"
+#include "core/a2dsymmatmulttracecore.h"
+
+namespace A2D {
+
+/*
+  Fused SymIsotropic(mu, lambda, E, S) followed by SymMatMultTrace(E, S, out)
+
+  With constant mu and lambda, out = tr(E * S(E)) and S is self-adjoint in E,
+  so the derivatives only involve E and the value of S:
+
+  out_p = 2 * tr(E_p * S)
+  E_b += 2 * out_b * S
+  E_h += 2 * out_h * S + 2 * out_b * S(E_p)
+
+  The seeds of S are not computed, so MakeFusedStack only fuses the pair when
+  no later operation may reference an object of the type of S, which is
+  decided at compile time. E and S have the same type as any other object of
+  that type, so whether the trace takes the same E and S objects as
+  SymIsotropic can't be seen in the types. It is checked on construction, and
+  for other objects, as in tr(S * S), the two operations are called one after
+  the other.
+*/
+template <class IsoExpr, class TraceExpr>
+class SymIsotropicTraceExpr {
+ public:
+  // Extract the numeric type to use
+  typedef typename IsoExpr::T T;
+
+  // Extract the dimensions of the matrices
+  static constexpr int N = IsoExpr::N;
+
+  A2D_FUNCTION SymIsotropicTraceExpr(const IsoExpr& iso,
+                                     const TraceExpr& trace)
+      : iso(iso),
+        trace(trace),
+        same_objects((&trace.S == &iso.E && &trace.E == &iso.S) ||
+                     (&trace.S == &iso.S && &trace.E == &iso.E)) {}
+
+  A2D_FUNCTION void eval() {
+    iso.eval();
+    trace.eval();
+  }
+
+  A2D_FUNCTION void bzero() {
+    if (!same_objects) {
+      iso.bzero();
+    }
+    trace.bzero();
+  }
+
+  template <ADorder forder>
+  A2D_FUNCTION void forward() {
+    if (same_objects) {
+      constexpr ADseed seed =
+          conditional_value<ADseed, forder == ADorder::FIRST, ADseed::b,
+                            ADseed::p>::value;
+      GetSeed<seed>::get_data(trace.out) =
+          T(2.0) * SymMatMultTraceCore<T, N>(GetSeed<seed>::get_data(iso.E),
+                                             get_data(iso.S));
+    } else {
+      iso.template forward<forder>();
+      trace.template forward<forder>();
+    }
+  }
+
+  A2D_FUNCTION void reverse() {
+    if (same_objects) {
+      SymMatMultTraceReverseCore<T, N>(T(2.0) * trace.out.bvalue(),
+                                       get_data(iso.S),
+                                       GetSeed<ADseed::b>::get_data(iso.E));
+    } else {
+      trace.reverse();
+      iso.reverse();
+    }
+  }
+
+  A2D_FUNCTION void hzero() {
+    if (!same_objects) {
+      iso.hzero();
+    }
+    trace.hzero();
+  }
+
+  A2D_FUNCTION void hreverse() {
+    if (same_objects) {
+      T Sp[N * (N + 1) / 2];
+      SymIsotropicCore<T, N>(get_data(iso.mu), get_data(iso.lambda),
+                             GetSeed<ADseed::p>::get_data(iso.E), Sp);
+      SymMatMultTraceReverseCore<T, N>(T(2.0) * trace.out.hvalue(),
+                                       get_data(iso.S),
+                                       GetSeed<ADseed::h>::get_data(iso.E));
+      SymMatMultTraceReverseCore<T, N>(T(2.0) * trace.out.bvalue(), Sp,
+                                       GetSeed<ADseed::h>::get_data(iso.E));
+    } else {
+      trace.hreverse();
+      iso.hreverse();
+    }
+  }
+
+ private:
+  IsoExpr iso;
+  TraceExpr trace;
+  const bool same_objects;
+};
+
+template <class mutype, class lamtype, class Etype, class Stype, class Atype,
+          class dtype>
+struct fused_operation<
+    SymIsotropicExpr<mutype, lamtype, Etype, Stype>,
+    SymMatMultTraceExpr<Atype, Atype, dtype>,
+    std::enable_if_t<get_diff_type<mutype>::diff_type == ADiffType::PASSIVE &&
+                     get_diff_type<lamtype>::diff_type == ADiffType::PASSIVE &&
+                     std::is_same<Etype, Stype>::value &&
+                     std::is_same<Etype, Atype>::value>> : std::true_type {
+  using type =
+      SymIsotropicTraceExpr<SymIsotropicExpr<mutype, lamtype, Etype, Stype>,
+                            SymMatMultTraceExpr<Atype, Atype, dtype>>;
+  using intermediate = typename remove_const_and_refs<
+      typename remove_a2dobj<Stype>::type>::type;
+};
+
+}  // namespace A2D
+
+#endif  // A2D_FUSION_H
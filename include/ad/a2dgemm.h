@@ -8,6 +8,7 @@
 #include "a2dstack.h"
 #include "a2dtest.h"
 #include "core/a2dgemmcore.h"
+#include "core/a2dgemmcorebatch.h"
 
 namespace A2D {
 
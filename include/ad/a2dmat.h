@@ -13,12 +13,14 @@ class Mat {
   static const index_t ncomp = M * N;
   static const int nrows = M;
   static const int ncols = N;
+  static constexpr std::size_t align = storage_alignment<T>::value;
 
   A2D_FUNCTION Mat() {
     for (int i = 0; i < M * N; i++) {
       A[i] = 0.0;
     }
   }
+  A2D_FUNCTION Mat(uninit_t) {}
   template <typename T2>
   A2D_FUNCTION Mat(const T2* vals) {
     for (int i = 0; i < M * N; i++) {
@@ -63,8 +65,8 @@ class Mat {
     return A[N * i + j];
   }
 
-  A2D_FUNCTION T* get_data() { return A; }
-  A2D_FUNCTION const T* get_data() const { return A; }
+  A2D_FUNCTION T* get_data() { return assume_aligned<align>(A); }
+  A2D_FUNCTION const T* get_data() const { return assume_aligned<align>(A); }
 
   template <typename I>
   A2D_FUNCTION T& operator[](const I i) {
@@ -77,7 +79,7 @@ class Mat {
   }
 
  private:
-  T A[M * N];
+  alignas(align) T A[M * N];
 };
 
 /*
@@ -99,12 +101,14 @@ class SymMat {
   static const index_t ncomp = MAT_SIZE;
   static constexpr int nrows = N;
   static constexpr int ncols = N;
+  static constexpr std::size_t align = storage_alignment<T>::value;
 
   A2D_FUNCTION SymMat() {
     for (int i = 0; i < MAT_SIZE; i++) {
       A[i] = 0.0;
     }
   }
+  A2D_FUNCTION SymMat(uninit_t) {}
   A2D_FUNCTION SymMat(const T* vals) {
     for (int i = 0; i < MAT_SIZE; i++) {
       A[i] = vals[i];
@@ -157,8 +161,8 @@ class SymMat {
     }
   }
 
-  A2D_FUNCTION T* get_data() { return A; }
-  A2D_FUNCTION const T* get_data() const { return A; }
+  A2D_FUNCTION T* get_data() { return assume_aligned<align>(A); }
+  A2D_FUNCTION const T* get_data() const { return assume_aligned<align>(A); }
 
   template <typename I>
   A2D_FUNCTION T& operator[](const I i) {
@@ -170,7 +174,7 @@ class SymMat {
   }
 
  private:
-  T A[MAT_SIZE];
+  alignas(align) T A[MAT_SIZE];
 };
 
 template <typename T>
@@ -275,6 +275,18 @@ inline bool MatDetTestAll(bool component = false, bool write_output = true) {
   passed = passed && Run(test3, component, write_output);
   SymMatDetTest<Tc, 3> test4;
   passed = passed && Run(test4, component, write_output);
+  MatDetTest<Tc, 4> test5;
+  passed = passed && Run(test5, component, write_output);
+  MatDetTest<Tc, 5> test6;
+  passed = passed && Run(test6, component, write_output);
+  MatDetTest<Tc, 6> test7;
+  passed = passed && Run(test7, component, write_output);
+  SymMatDetTest<Tc, 4> test8;
+  passed = passed && Run(test8, component, write_output);
+  SymMatDetTest<Tc, 5> test9;
+  passed = passed && Run(test9, component, write_output);
+  SymMatDetTest<Tc, 6> test10;
+  passed = passed && Run(test10, component, write_output);
 
   return passed;
 }
@@ -95,10 +95,10 @@ class MatInvExpr {
     T Ab[N * N], temp[N * N];
     const bool additive = true;
 
-    // Compute the derivative contribution
+    // Compute the derivative contribution Ab = - A^{-T} * Ainvb * A^{-T}
     MatMatMultCore<T, N, N, N, N, N, N, TRANSPOSE, NORMAL>(
         get_data(Ainv), GetSeed<ADseed::b>::get_data(Ainv), temp);
-    MatMatMultScaleCore<T, N, N, N, N, N, N, NORMAL, TRANSPOSE, additive>(
+    MatMatMultScaleCore<T, N, N, N, N, N, N, NORMAL, TRANSPOSE>(
         T(-1.0), temp, get_data(Ainv), Ab);
 
     // - A^{-T} * Ap^{T} * Ab
@@ -194,6 +194,12 @@ inline bool MatInvTestAll(bool component = false, bool write_output = true) {
   passed = passed && Run(test1, component, write_output);
   MatInvTest<Tc, 3> test2;
   passed = passed && Run(test2, component, write_output);
+  MatInvTest<Tc, 4> test3;
+  passed = passed && Run(test3, component, write_output);
+  MatInvTest<Tc, 5> test4;
+  passed = passed && Run(test4, component, write_output);
+  MatInvTest<Tc, 6> test5;
+  passed = passed && Run(test5, component, write_output);
 
   return passed;
 }
@@ -0,0 +1,468 @@
+#ifndef A2D_MAT_SOLVE_H
+#define A2D_MAT_SOLVE_H
+
+#include <type_traits>
+
+#include "../a2ddefs.h"
+#include "a2dmat.h"
+#include "a2dobj.h"
+#include "a2dstack.h"
+#include "a2dtest.h"
+#include "a2dvec.h"
+#include "core/a2dmatlucore.h"
+#include "core/a2dmatveccore.h"
+#include "core/a2dsymmatveccore.h"
+#include "core/a2dveccore.h"
+
+namespace A2D {
+
+/*
+  Solve A * x = b for small matrices without forming A^{-1}
+
+  The LU factorization of A is computed once in eval() and stored with the
+  expression, so that the derivatives only require triangular solves:
+
+  dot{x} = A^{-1} * (dot{b} - dot{A} * x)
+
+  w = A^{-T} * xb,  bb = w,  Ab = - w * x^{T}
+
+  The second-order terms follow from differentiating w:
+
+  wh = A^{-T} * (xh - Ap^{T} * w)
+
+  bh = wh,  Ah = - wh * x^{T} - w * xp^{T}
+
+  For a symmetric matrix the same factorization is used (A need not be
+  positive definite) and the off-diagonal derivatives include both the (i, j)
+  and (j, i) entries.
+*/
+
+template <typename T, int N>
+A2D_FUNCTION void MatSolve(const Mat<T, N, N>& A, const Vec<T, N>& b,
+                           Vec<T, N>& x) {
+  T LU[N * N], perm[N], sign;
+  MatLUFactorCore<T, N>(get_data(A), LU, perm, sign);
+  MatLUSolveCore<T, N>(LU, perm, get_data(b), get_data(x));
+}
+
+template <typename T, int N>
+A2D_FUNCTION void MatSolve(const SymMat<T, N>& S, const Vec<T, N>& b,
+                           Vec<T, N>& x) {
+  T A[N * N], LU[N * N], perm[N], sign;
+  SymMatToMatCore<T, N>(get_data(S), A);
+  MatLUFactorCore<T, N>(A, LU, perm, sign);
+  MatLUSolveCore<T, N>(LU, perm, get_data(b), get_data(x));
+}
+
+template <class Atype, class btype, class xtype>
+class MatSolveExpr {
+ public:
+  // Extract the numeric type to use
+  typedef typename get_object_numeric_type<xtype>::type T;
+
+  // Extract the dimensions of the matrix and vectors
+  static constexpr int N = get_matrix_rows<Atype>::size;
+  static constexpr int M = get_matrix_columns<Atype>::size;
+  static constexpr int K = get_vec_size<btype>::size;
+  static constexpr int P = get_vec_size<xtype>::size;
+
+  static_assert(N == M, "Matrix must be square");
+  static_assert(N == K && N == P, "Matrix and vector dimensions must agree");
+
+  // Get the types of the inputs
+  static constexpr ADiffType adA = get_diff_type<Atype>::diff_type;
+  static constexpr ADiffType adb = get_diff_type<btype>::diff_type;
+
+  // Get the differentiation order from the output
+  static constexpr ADorder order = get_diff_order<xtype>::order;
+
+  A2D_FUNCTION MatSolveExpr(Atype& A, btype& b, xtype& x) : A(A), b(b), x(x) {}
+
+  A2D_FUNCTION void eval() {
+    MatLUFactorCore<T, N>(get_data(A), LU, perm, sign);
+    MatLUSolveCore<T, N>(LU, perm, get_data(b), get_data(x));
+  }
+
+  A2D_FUNCTION void bzero() { x.bzero(); }
+
+  template <ADorder forder>
+  A2D_FUNCTION void forward() {
+    static_assert(
+        !(order == ADorder::FIRST and forder == ADorder::SECOND),
+        "Can't perform second order forward with first order objects");
+    constexpr ADseed seed = conditional_value<ADseed, forder == ADorder::FIRST,
+                                              ADseed::b, ADseed::p>::value;
+
+    // r = dot{b} - dot{A} * x
+    T r[N];
+    if constexpr (adA == ADiffType::ACTIVE) {
+      MatVecCore<T, N, N>(GetSeed<seed>::get_data(A), get_data(x), r);
+      for (int i = 0; i < N; i++) {
+        r[i] = -r[i];
+      }
+      if constexpr (adb == ADiffType::ACTIVE) {
+        VecAddCore<T, N>(GetSeed<seed>::get_data(b), r);
+      }
+    } else if constexpr (adb == ADiffType::ACTIVE) {
+      VecCopyCore<T, N>(GetSeed<seed>::get_data(b), r);
+    }
+    MatLUSolveCore<T, N>(LU, perm, r, GetSeed<seed>::get_data(x));
+  }
+
+  A2D_FUNCTION void reverse() {
+    constexpr bool additive = true;
+    T w[N];
+    MatLUSolveTransposeCore<T, N>(LU, perm, GetSeed<ADseed::b>::get_data(x),
+                                  w);
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(w, GetSeed<ADseed::b>::get_data(b));
+    }
+    if constexpr (adA == ADiffType::ACTIVE) {
+      VecOuterCore<T, N, N, additive>(T(-1.0), w, get_data(x),
+                                      GetSeed<ADseed::b>::get_data(A));
+    }
+  }
+
+  A2D_FUNCTION void hzero() { x.hzero(); }
+
+  A2D_FUNCTION void hreverse() {
+    static_assert(order == ADorder::SECOND,
+                  "hreverse() can be called for only second order objects.");
+    constexpr bool additive = true;
+
+    // r = xh - Ap^{T} * w, where w = A^{-T} * xb
+    T w[N], r[N], wh[N];
+    VecCopyCore<T, N>(GetSeed<ADseed::h>::get_data(x), r);
+    if constexpr (adA == ADiffType::ACTIVE) {
+      MatLUSolveTransposeCore<T, N>(LU, perm, GetSeed<ADseed::b>::get_data(x),
+                                    w);
+      T t[N];
+      MatVecCore<T, N, N, MatOp::TRANSPOSE>(GetSeed<ADseed::p>::get_data(A),
+                                            w, t);
+      for (int i = 0; i < N; i++) {
+        r[i] -= t[i];
+      }
+    }
+    MatLUSolveTransposeCore<T, N>(LU, perm, r, wh);
+
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(wh, GetSeed<ADseed::h>::get_data(b));
+    }
+    if constexpr (adA == ADiffType::ACTIVE) {
+      VecOuterCore<T, N, N, additive>(T(-1.0), wh, get_data(x),
+                                      GetSeed<ADseed::h>::get_data(A));
+      VecOuterCore<T, N, N, additive>(T(-1.0), w,
+                                      GetSeed<ADseed::p>::get_data(x),
+                                      GetSeed<ADseed::h>::get_data(A));
+    }
+  }
+
+ private:
+  Atype& A;
+  btype& b;
+  xtype& x;
+
+  // The LU factorization of A computed in eval()
+  T LU[N * N], perm[N], sign;
+};
+
+template <class Stype, class btype, class xtype>
+class SymMatSolveExpr {
+ public:
+  // Extract the numeric type to use
+  typedef typename get_object_numeric_type<xtype>::type T;
+
+  // Extract the dimensions of the matrix and vectors
+  static constexpr int N = get_symmatrix_size<Stype>::size;
+  static constexpr int K = get_vec_size<btype>::size;
+  static constexpr int P = get_vec_size<xtype>::size;
+
+  static_assert(N == K && N == P, "Matrix and vector dimensions must agree");
+
+  // Get the types of the inputs
+  static constexpr ADiffType adS = get_diff_type<Stype>::diff_type;
+  static constexpr ADiffType adb = get_diff_type<btype>::diff_type;
+
+  // Get the differentiation order from the output
+  static constexpr ADorder order = get_diff_order<xtype>::order;
+
+  A2D_FUNCTION SymMatSolveExpr(Stype& S, btype& b, xtype& x)
+      : S(S), b(b), x(x) {}
+
+  A2D_FUNCTION void eval() {
+    T A[N * N];
+    SymMatToMatCore<T, N>(get_data(S), A);
+    MatLUFactorCore<T, N>(A, LU, perm, sign);
+    MatLUSolveCore<T, N>(LU, perm, get_data(b), get_data(x));
+  }
+
+  A2D_FUNCTION void bzero() { x.bzero(); }
+
+  template <ADorder forder>
+  A2D_FUNCTION void forward() {
+    static_assert(
+        !(order == ADorder::FIRST and forder == ADorder::SECOND),
+        "Can't perform second order forward with first order objects");
+    constexpr ADseed seed = conditional_value<ADseed, forder == ADorder::FIRST,
+                                              ADseed::b, ADseed::p>::value;
+
+    // r = dot{b} - dot{S} * x
+    T r[N];
+    if constexpr (adS == ADiffType::ACTIVE) {
+      SymMatVecCore<T, N>(GetSeed<seed>::get_data(S), get_data(x), r);
+      for (int i = 0; i < N; i++) {
+        r[i] = -r[i];
+      }
+      if constexpr (adb == ADiffType::ACTIVE) {
+        VecAddCore<T, N>(GetSeed<seed>::get_data(b), r);
+      }
+    } else if constexpr (adb == ADiffType::ACTIVE) {
+      VecCopyCore<T, N>(GetSeed<seed>::get_data(b), r);
+    }
+    MatLUSolveCore<T, N>(LU, perm, r, GetSeed<seed>::get_data(x));
+  }
+
+  A2D_FUNCTION void reverse() {
+    constexpr bool additive = true;
+    T w[N];
+    MatLUSolveTransposeCore<T, N>(LU, perm, GetSeed<ADseed::b>::get_data(x),
+                                  w);
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(w, GetSeed<ADseed::b>::get_data(b));
+    }
+    if constexpr (adS == ADiffType::ACTIVE) {
+      for (int i = 0; i < N; i++) {
+        w[i] = -w[i];
+      }
+      DiagonalPreservingVecSymOuterCore<T, N, additive>(
+          w, get_data(x), GetSeed<ADseed::b>::get_data(S));
+    }
+  }
+
+  A2D_FUNCTION void hzero() { x.hzero(); }
+
+  A2D_FUNCTION void hreverse() {
+    static_assert(order == ADorder::SECOND,
+                  "hreverse() can be called for only second order objects.");
+    constexpr bool additive = true;
+
+    // r = xh - Sp * w, where w = S^{-1} * xb
+    T w[N], r[N], wh[N];
+    VecCopyCore<T, N>(GetSeed<ADseed::h>::get_data(x), r);
+    if constexpr (adS == ADiffType::ACTIVE) {
+      MatLUSolveTransposeCore<T, N>(LU, perm, GetSeed<ADseed::b>::get_data(x),
+                                    w);
+      T t[N];
+      SymMatVecCore<T, N>(GetSeed<ADseed::p>::get_data(S), w, t);
+      for (int i = 0; i < N; i++) {
+        r[i] -= t[i];
+      }
+    }
+    MatLUSolveTransposeCore<T, N>(LU, perm, r, wh);
+
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(wh, GetSeed<ADseed::h>::get_data(b));
+    }
+    if constexpr (adS == ADiffType::ACTIVE) {
+      for (int i = 0; i < N; i++) {
+        w[i] = -w[i];
+        wh[i] = -wh[i];
+      }
+      DiagonalPreservingVecSymOuterCore<T, N, additive>(
+          wh, get_data(x), GetSeed<ADseed::h>::get_data(S));
+      DiagonalPreservingVecSymOuterCore<T, N, additive>(
+          w, GetSeed<ADseed::p>::get_data(x), GetSeed<ADseed::h>::get_data(S));
+    }
+  }
+
+ private:
+  Stype& S;
+  btype& b;
+  xtype& x;
+
+  // The LU factorization of the expanded matrix computed in eval()
+  T LU[N * N], perm[N], sign;
+};
+
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(ADObj<Atype>& A, ADObj<btype>& b, ADObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<ADObj<Atype>, ADObj<btype>, ADObj<xtype>>(A, b, x);
+  } else {
+    return MatSolveExpr<ADObj<Atype>, ADObj<btype>, ADObj<xtype>>(A, b, x);
+  }
+}
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(A2DObj<Atype>& A, A2DObj<btype>& b,
+                           A2DObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<A2DObj<Atype>, A2DObj<btype>, A2DObj<xtype>>(A, b,
+                                                                        x);
+  } else {
+    return MatSolveExpr<A2DObj<Atype>, A2DObj<btype>, A2DObj<xtype>>(A, b, x);
+  }
+}
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(ADObj<Atype>& A, const btype& b, ADObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<ADObj<Atype>, const btype, ADObj<xtype>>(A, b, x);
+  } else {
+    return MatSolveExpr<ADObj<Atype>, const btype, ADObj<xtype>>(A, b, x);
+  }
+}
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(A2DObj<Atype>& A, const btype& b,
+                           A2DObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<A2DObj<Atype>, const btype, A2DObj<xtype>>(A, b, x);
+  } else {
+    return MatSolveExpr<A2DObj<Atype>, const btype, A2DObj<xtype>>(A, b, x);
+  }
+}
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(const Atype& A, ADObj<btype>& b, ADObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<const Atype, ADObj<btype>, ADObj<xtype>>(A, b, x);
+  } else {
+    return MatSolveExpr<const Atype, ADObj<btype>, ADObj<xtype>>(A, b, x);
+  }
+}
+template <class Atype, class btype, class xtype>
+A2D_FUNCTION auto MatSolve(const Atype& A, A2DObj<btype>& b,
+                           A2DObj<xtype>& x) {
+  if constexpr (get_a2d_object_type<Atype>::value == ADObjType::SYMMAT) {
+    return SymMatSolveExpr<const Atype, A2DObj<btype>, A2DObj<xtype>>(A, b, x);
+  } else {
+    return MatSolveExpr<const Atype, A2DObj<btype>, A2DObj<xtype>>(A, b, x);
+  }
+}
+
+namespace Test {
+
+template <typename T, int N>
+class MatSolveTest : public A2DTest<T, Vec<T, N>, Mat<T, N, N>, Vec<T, N>> {
+ public:
+  using Input = VarTuple<T, Mat<T, N, N>, Vec<T, N>>;
+  using Output = VarTuple<T, Vec<T, N>>;
+
+  // Assemble a string to describe the test
+  std::string name() {
+    std::stringstream s;
+    s << "MatSolve<" << N << ">";
+    return s.str();
+  }
+
+  // Evaluate the solution
+  Output eval(const Input& X) {
+    Mat<T, N, N> A;
+    Vec<T, N> b, x;
+    X.get_values(A, b);
+    MatSolve(A, b, x);
+    return MakeVarTuple<T>(x);
+  }
+
+  // Compute the derivative
+  void deriv(const Output& seed, const Input& X, Input& g) {
+    ADObj<Mat<T, N, N>> A;
+    ADObj<Vec<T, N>> b, x;
+
+    X.get_values(A.value(), b.value());
+    auto stack = MakeStack(MatSolve(A, b, x));
+    seed.get_values(x.bvalue());
+    stack.reverse();
+    g.set_values(A.bvalue(), b.bvalue());
+  }
+
+  // Compute the second-derivative
+  void hprod(const Output& seed, const Output& hval, const Input& X,
+             const Input& p, Input& h) {
+    A2DObj<Mat<T, N, N>> A;
+    A2DObj<Vec<T, N>> b, x;
+
+    X.get_values(A.value(), b.value());
+    p.get_values(A.pvalue(), b.pvalue());
+    auto stack = MakeStack(MatSolve(A, b, x));
+    seed.get_values(x.bvalue());
+    hval.get_values(x.hvalue());
+    stack.hproduct();
+    h.set_values(A.hvalue(), b.hvalue());
+  }
+};
+
+template <typename T, int N>
+class SymMatSolveTest
+    : public A2DTest<T, Vec<T, N>, SymMat<T, N>, Vec<T, N>> {
+ public:
+  using Input = VarTuple<T, SymMat<T, N>, Vec<T, N>>;
+  using Output = VarTuple<T, Vec<T, N>>;
+
+  // Assemble a string to describe the test
+  std::string name() {
+    std::stringstream s;
+    s << "SymMatSolve<" << N << ">";
+    return s.str();
+  }
+
+  // Evaluate the solution
+  Output eval(const Input& X) {
+    SymMat<T, N> S;
+    Vec<T, N> b, x;
+    X.get_values(S, b);
+    MatSolve(S, b, x);
+    return MakeVarTuple<T>(x);
+  }
+
+  // Compute the derivative
+  void deriv(const Output& seed, const Input& X, Input& g) {
+    ADObj<SymMat<T, N>> S;
+    ADObj<Vec<T, N>> b, x;
+
+    X.get_values(S.value(), b.value());
+    auto stack = MakeStack(MatSolve(S, b, x));
+    seed.get_values(x.bvalue());
+    stack.reverse();
+    g.set_values(S.bvalue(), b.bvalue());
+  }
+
+  // Compute the second-derivative
+  void hprod(const Output& seed, const Output& hval, const Input& X,
+             const Input& p, Input& h) {
+    A2DObj<SymMat<T, N>> S;
+    A2DObj<Vec<T, N>> b, x;
+
+    X.get_values(S.value(), b.value());
+    p.get_values(S.pvalue(), b.pvalue());
+    auto stack = MakeStack(MatSolve(S, b, x));
+    seed.get_values(x.bvalue());
+    hval.get_values(x.hvalue());
+    stack.hproduct();
+    h.set_values(S.hvalue(), b.hvalue());
+  }
+};
+
+inline bool MatSolveTestAll(bool component = false, bool write_output = true) {
+  using Tc = A2D_complex_t<double>;
+
+  bool passed = true;
+  MatSolveTest<Tc, 1> test1;
+  passed = passed && Run(test1, component, write_output);
+  MatSolveTest<Tc, 3> test2;
+  passed = passed && Run(test2, component, write_output);
+  MatSolveTest<Tc, 5> test3;
+  passed = passed && Run(test3, component, write_output);
+
+  SymMatSolveTest<Tc, 2> test4;
+  passed = passed && Run(test4, component, write_output);
+  SymMatSolveTest<Tc, 3> test5;
+  passed = passed && Run(test5, component, write_output);
+  SymMatSolveTest<Tc, 6> test6;
+  passed = passed && Run(test6, component, write_output);
+
+  return passed;
+}
+
+}  // namespace Test
+
+}  // namespace A2D
+
+#endif  // A2D_MAT_SOLVE_H
@@ -217,7 +217,7 @@ class MatSumScaleExpr {
     }
   }
 
-  A2D_FUNCTION void bzero() { B.bzero(); }
+  A2D_FUNCTION void bzero() { C.bzero(); }
 
   A2D_FUNCTION void reverse() {
     constexpr ADseed seed = ADseed::b;
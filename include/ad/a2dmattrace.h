@@ -149,6 +149,8 @@ class SymTraceExpr {
     get_data(tr) = SymMatTraceCore<T, M>(get_data(S));
   }
 
+  A2D_FUNCTION void bzero() { tr.bzero(); }
+
   template <ADorder forder>
   A2D_FUNCTION void forward() {
     static_assert(
@@ -165,6 +167,8 @@ class SymTraceExpr {
                             GetSeed<ADseed::b>::get_data(S));
   }
 
+  A2D_FUNCTION void hzero() { tr.hzero(); }
+
   A2D_FUNCTION void hreverse() {
     SymMatAddDiagCore<T, M>(GetSeed<ADseed::h>::get_data(tr),
                             GetSeed<ADseed::h>::get_data(S));
@@ -2,8 +2,10 @@
 #define A2D_OBJECTS_H
 
 #include "../a2ddefs.h"
+#include "../a2dsimd.h"
 #include "a2dmat.h"
 #include "a2dvec.h"
+#include "a2dview.h"
 #include "adscalar.h"
 
 namespace A2D {
@@ -45,6 +47,21 @@ class ADObj : public ADExpr<ADObj<T>, T> {
     }
   }
 
+  // Leave the value uninitialized and zero only the seed. This is intended
+  // for intermediates: the value is set by eval() and the seed is accumulated
+  // into by reverse()
+  template <typename U = T,
+            std::enable_if_t<!is_scalar_type<U>::value &&
+                                 !std::is_reference<U>::value,
+                             bool> = true>
+  A2D_FUNCTION ADObj(uninit_t) : A(uninit), Ab() {}
+
+  template <typename U = T,
+            std::enable_if_t<is_scalar_type<U>::value &&
+                                 !std::is_reference<U>::value,
+                             bool> = true>
+  A2D_FUNCTION ADObj(uninit_t) : Ab(0.0) {}
+
   // If this is a scalar, non-reference type - initialize values to zero
   A2D_FUNCTION ADObj(const T& A) : A(A) {
     if constexpr (is_scalar_type<T>::value && !std::is_reference<T>::value) {
@@ -159,6 +176,22 @@ class A2DObj : public A2DExpr<A2DObj<T>, T> {
       A = Ab = Ap = Ah = type(0.0);
     }
   }
+
+  // Leave the value and the projected seed uninitialized, since they are set
+  // by eval() and forward(), and zero the seeds that reverse() and hreverse()
+  // accumulate into
+  template <typename U = T,
+            std::enable_if_t<!is_scalar_type<U>::value &&
+                                 !std::is_reference<U>::value,
+                             bool> = true>
+  A2D_FUNCTION A2DObj(uninit_t) : A(uninit), Ab(), Ap(uninit), Ah() {}
+
+  template <typename U = T,
+            std::enable_if_t<is_scalar_type<U>::value &&
+                                 !std::is_reference<U>::value,
+                             bool> = true>
+  A2D_FUNCTION A2DObj(uninit_t) : Ab(0.0), Ah(0.0) {}
+
   A2D_FUNCTION A2DObj(const T& A) : A(A) {
     if constexpr (is_scalar_type<T>::value && !std::is_reference<T>::value) {
       Ab = Ap = Ah = type(0.0);
@@ -720,6 +753,27 @@ class GetSeed {
       return mat.hvalue().get_data();
     }
   }
+
+  template <class View,
+            std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+  static A2D_FUNCTION typename View::type* get_data(ADObj<View>& view) {
+    static_assert(seed == ADseed::b, "Incompatible seed type for ADObj");
+    return view.bvalue().get_data();
+  }
+
+  template <class View,
+            std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+  static A2D_FUNCTION typename View::type* get_data(A2DObj<View>& view) {
+    static_assert(seed == ADseed::b or seed == ADseed::p or seed == ADseed::h,
+                  "Incompatible seed type for A2DObj");
+    if constexpr (seed == ADseed::b) {
+      return view.bvalue().get_data();
+    } else if constexpr (seed == ADseed::p) {
+      return view.pvalue().get_data();
+    } else {  // seed == ADseed::h
+      return view.hvalue().get_data();
+    }
+  }
 };
 
 template <typename T, std::enable_if_t<is_numeric_type<T>::value, bool> = true>
@@ -845,6 +899,26 @@ A2D_FUNCTION T* get_data(A2DObj<Vec<T, n>&>& vec) {
   return vec.value().get_data();
 }
 
+template <class View, std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+A2D_FUNCTION typename View::type* get_data(View& view) {
+  return view.get_data();
+}
+
+template <class View, std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+A2D_FUNCTION const typename View::type* get_data(const View& view) {
+  return view.get_data();
+}
+
+template <class View, std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+A2D_FUNCTION typename View::type* get_data(ADObj<View>& view) {
+  return view.value().get_data();
+}
+
+template <class View, std::enable_if_t<is_a2d_view<View>::value, bool> = true>
+A2D_FUNCTION typename View::type* get_data(A2DObj<View>& view) {
+  return view.value().get_data();
+}
+
 // new ADScalar get_data  (SPE)
 template <class T, int N>
 struct __is_numeric_type<ADScalar<T, N>> : std::is_floating_point<T> {};
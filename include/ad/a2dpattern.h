@@ -0,0 +1,97 @@
+#ifndef A2D_PATTERN_H
+#define A2D_PATTERN_H
+
+#include "../a2ddefs.h"
+
+namespace A2D {
+
+/**
+ * @brief Nonzero pattern and column coloring of an M x N Jacobian
+ *
+ * Two columns can share a color when they have no nonzero row in common.
+ * All the columns of one color are then recovered from a single
+ * Hessian-vector product whose direction is the sum of their unit vectors.
+ *
+ * @tparam M Number of rows (output components)
+ * @tparam N Number of columns (input components)
+ */
+template <index_t M, index_t N>
+class JacobianPattern {
+ public:
+  static constexpr index_t nrows = M;
+  static constexpr index_t ncols = N;
+
+  A2D_FUNCTION JacobianPattern() : num_colors(0) {
+    for (index_t i = 0; i < M * N; i++) {
+      nz[i] = false;
+    }
+    for (index_t j = 0; j < N; j++) {
+      color[j] = 0;
+    }
+  }
+
+  // Access the pattern
+  A2D_FUNCTION bool& operator()(const index_t i, const index_t j) {
+    return nz[N * i + j];
+  }
+  A2D_FUNCTION const bool& operator()(const index_t i, const index_t j) const {
+    return nz[N * i + j];
+  }
+
+  // Number of nonzero entries
+  A2D_FUNCTION index_t get_num_nonzeros() const {
+    index_t nnz = 0;
+    for (index_t i = 0; i < M * N; i++) {
+      if (nz[i]) {
+        nnz++;
+      }
+    }
+    return nnz;
+  }
+
+  /**
+   * @brief Greedy coloring of the columns in their natural order
+   *
+   * Each column gets the smallest color not used by an earlier column that
+   * shares a nonzero row with it.
+   */
+  A2D_FUNCTION void color_columns() {
+    num_colors = 0;
+    for (index_t j = 0; j < N; j++) {
+      bool forbidden[N];
+      for (index_t c = 0; c < N; c++) {
+        forbidden[c] = false;
+      }
+      for (index_t k = 0; k < j; k++) {
+        for (index_t i = 0; i < M; i++) {
+          if (nz[N * i + j] && nz[N * i + k]) {
+            forbidden[color[k]] = true;
+            break;
+          }
+        }
+      }
+
+      index_t c = 0;
+      while (forbidden[c]) {
+        c++;
+      }
+      color[j] = c;
+      if (c + 1 > num_colors) {
+        num_colors = c + 1;
+      }
+    }
+  }
+
+  // Color of each column
+  index_t color[N];
+
+  // Number of colors = number of sweeps needed for the extraction
+  index_t num_colors;
+
+ private:
+  bool nz[M * N];
+};
+
+}  // namespace A2D
+
+#endif  // A2D_PATTERN_H
@@ -0,0 +1,210 @@
+#ifndef A2D_SPARSE_H
+#define A2D_SPARSE_H
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#if !(defined(__GNUC__) || defined(__clang__))
+#include <atomic>
+#endif
+
+#include "../a2ddefs.h"
+
+namespace A2D {
+
+/*
+  Add v to x with a compare-and-swap loop so that threads can add to the same
+  entry without locks. The GCC/Clang __atomic builtins work on plain objects;
+  other compilers need C++20 std::atomic_ref.
+*/
+template <typename T>
+inline void atomic_add(T& x, const T v) {
+  static_assert(std::is_floating_point<T>::value,
+                "atomic_add requires a floating point type");
+#if defined(__GNUC__) || defined(__clang__)
+  T expected, desired;
+  __atomic_load(&x, &expected, __ATOMIC_RELAXED);
+  do {
+    desired = expected + v;
+  } while (!__atomic_compare_exchange(&x, &expected, &desired, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#elif defined(__cpp_lib_atomic_ref)
+  std::atomic_ref<T>(x).fetch_add(v, std::memory_order_relaxed);
+#else
+#error "atomic_add requires the __atomic builtins or std::atomic_ref"
+#endif
+}
+
+/**
+ * @brief Block compressed sparse row matrix with M x M blocks
+ *
+ * The nonzero pattern is built from the element connectivity: block (i, j)
+ * is nonzero when nodes i and j share an element. The position of the block of
+ * each pair of nodes of each element is stored, so that adding an element
+ * matrix only reads the stored positions and does no search.
+ *
+ * The element matrices are Mat or SymMat of size nodes_per_elem * M, with
+ * the element degrees of freedom M * a + i for the variable i of the a-th
+ * node of the element.
+ *
+ * @tparam T Scalar type
+ * @tparam M Block size, the number of variables at each node
+ */
+template <typename T, index_t M>
+class BSRMat {
+ public:
+  static constexpr index_t block_size = M;
+
+  /**
+   * @param nelems Number of elements
+   * @param nodes_per_elem Number of nodes of each element
+   * @param conn Element connectivity
+   */
+  BSRMat(index_t nelems, index_t nodes_per_elem, const index_t conn[])
+      : nodes_per_elem(nodes_per_elem), nbrows(0) {
+    for (index_t i = 0; i < nelems * nodes_per_elem; i++) {
+      nbrows = std::max(nbrows, conn[i] + 1);
+    }
+
+    // Elements that contain each node
+    std::vector<index_t> node_ptr(nbrows + 1, 0);
+    for (index_t i = 0; i < nelems * nodes_per_elem; i++) {
+      node_ptr[conn[i] + 1]++;
+    }
+    for (index_t n = 0; n < nbrows; n++) {
+      node_ptr[n + 1] += node_ptr[n];
+    }
+    std::vector<index_t> node_elems(node_ptr[nbrows]);
+    std::vector<index_t> pos(node_ptr.begin(), node_ptr.end() - 1);
+    for (index_t e = 0; e < nelems; e++) {
+      for (index_t j = 0; j < nodes_per_elem; j++) {
+        node_elems[pos[conn[nodes_per_elem * e + j]]++] = e;
+      }
+    }
+
+    // The sorted columns of each block row are the nodes of the elements
+    // that contain the row node
+    rowp.assign(nbrows + 1, 0);
+    std::vector<index_t> row;
+    for (index_t i = 0; i < nbrows; i++) {
+      row.clear();
+      for (index_t k = node_ptr[i]; k < node_ptr[i + 1]; k++) {
+        const index_t* nodes = &conn[nodes_per_elem * node_elems[k]];
+        row.insert(row.end(), nodes, nodes + nodes_per_elem);
+      }
+      std::sort(row.begin(), row.end());
+      row.erase(std::unique(row.begin(), row.end()), row.end());
+      cols.insert(cols.end(), row.begin(), row.end());
+      rowp[i + 1] = cols.size();
+    }
+    vals.assign(M * M * cols.size(), T(0.0));
+
+    // Position of the block of each pair of nodes of each element
+    elem_blocks.resize(nelems * nodes_per_elem * nodes_per_elem);
+    for (index_t e = 0; e < nelems; e++) {
+      const index_t* nodes = &conn[nodes_per_elem * e];
+      for (index_t a = 0; a < nodes_per_elem; a++) {
+        for (index_t b = 0; b < nodes_per_elem; b++) {
+          elem_blocks[nodes_per_elem * (nodes_per_elem * e + a) + b] =
+              find_block(nodes[a], nodes[b]);
+        }
+      }
+    }
+  }
+
+  index_t get_num_block_rows() const { return nbrows; }
+  index_t get_num_rows() const { return M * nbrows; }
+  index_t get_num_blocks() const { return cols.size(); }
+
+  // Index of block (i, j), or NO_INDEX when it is not in the pattern
+  index_t find_block(index_t i, index_t j) const {
+    auto begin = cols.begin() + rowp[i], end = cols.begin() + rowp[i + 1];
+    auto it = std::lower_bound(begin, end, j);
+    if (it != end && *it == j) {
+      return it - cols.begin();
+    }
+    return NO_INDEX;
+  }
+
+  // Access the entries of block k in row-major order
+  T* get_block(index_t k) { return &vals[M * M * k]; }
+  const T* get_block(index_t k) const { return &vals[M * M * k]; }
+
+  void zero() { std::fill(vals.begin(), vals.end(), T(0.0)); }
+
+  // Add the element matrix ke of element elem. Threads may only add
+  // elements that share no node at the same time, as for one color of an
+  // ElementColoring.
+  template <class ElemMat>
+  void add_element(index_t elem, const ElemMat& ke) {
+    add_element_<false>(elem, ke);
+  }
+
+  // Add the element matrix ke of element elem with atomic additions, so that
+  // any elements can be added at the same time
+  template <class ElemMat>
+  void add_element_atomic(index_t elem, const ElemMat& ke) {
+    add_element_<true>(elem, ke);
+  }
+
+  // Compute y = A * x
+  void mult(const T x[], T y[]) const {
+    for (index_t i = 0; i < nbrows; i++) {
+      T yi[M] = {};
+      for (index_t k = rowp[i]; k < rowp[i + 1]; k++) {
+        const T* blk = get_block(k);
+        const T* xj = &x[M * cols[k]];
+        for (index_t ii = 0; ii < M; ii++) {
+          for (index_t jj = 0; jj < M; jj++) {
+            yi[ii] += blk[M * ii + jj] * xj[jj];
+          }
+        }
+      }
+      for (index_t ii = 0; ii < M; ii++) {
+        y[M * i + ii] = yi[ii];
+      }
+    }
+  }
+
+  std::vector<index_t> rowp;  // Offsets of each block row into cols
+  std::vector<index_t> cols;  // Block column indices
+  std::vector<T> vals;        // Entries, M * M per block
+
+ private:
+  template <bool atomic, class ElemMat>
+  void add_element_(index_t elem, const ElemMat& ke) {
+    static_assert(ElemMat::nrows == ElemMat::ncols && ElemMat::nrows % M == 0,
+                  "The element matrix must be square with M x M blocks");
+    constexpr index_t nodes = ElemMat::nrows / M;
+    assert(nodes == nodes_per_elem &&
+           "The element matrix size must match the nodes per element");
+    const index_t* blocks =
+        &elem_blocks[nodes_per_elem * nodes_per_elem * elem];
+    for (index_t a = 0; a < nodes; a++) {
+      for (index_t b = 0; b < nodes; b++) {
+        T* blk = get_block(blocks[nodes_per_elem * a + b]);
+        for (index_t i = 0; i < M; i++) {
+          for (index_t j = 0; j < M; j++) {
+            if constexpr (atomic) {
+              atomic_add(blk[M * i + j], T(ke(M * a + i, M * b + j)));
+            } else {
+              blk[M * i + j] += ke(M * a + i, M * b + j);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const index_t nodes_per_elem;
+  index_t nbrows;
+
+  // Block index of each pair of nodes of each element
+  std::vector<index_t> elem_blocks;
+};
+
+}  // namespace A2D
+
+#endif  // A2D_SPARSE_H
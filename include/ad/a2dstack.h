@@ -1,24 +1,122 @@
 #ifndef A2D_STACK_H
 #define A2D_STACK_H
 
+#include <utility>
+
 #include "../a2ddefs.h"
 #include "../a2dtuple.h"
+#include "a2dbatch.h"
 #include "a2dobj.h"
+#include "a2dpattern.h"
 #include "a2dtuple.h"
+#include "core/a2dmatveccore.h"
+#include "core/a2dsymmatveccore.h"
 
 namespace A2D {
 
+/*
+  Check at compile time whether an operation may reference the object
+  A2DObj<Obj> by looking through the template arguments of its type.
+
+  The check is conservative: reference objects A2DObj<T&> and objects of views
+  can alias the entries of any object, and types whose template arguments
+  can't be inspected are assumed to reference the object.
+*/
+template <class Obj, class T>
+struct __op_references
+    : std::integral_constant<bool, !(is_scalar_type<T>::value ||
+                                     is_a2d_matrix<T>::value ||
+                                     is_a2d_sym_matrix<T>::value ||
+                                     is_a2d_vector<T>::value)> {};
+
+template <class Obj, class T>
+struct op_references
+    : __op_references<Obj, typename remove_const_and_refs<T>::type> {};
+
+template <class Obj, class U>
+struct __op_references<Obj, ADObj<U>>
+    : std::integral_constant<
+          bool, std::is_reference<U>::value || is_a2d_view<U>::value ||
+                    std::is_same<typename std::remove_const<U>::type,
+                                 Obj>::value> {};
+
+template <class Obj, class U>
+struct __op_references<Obj, A2DObj<U>>
+    : std::integral_constant<
+          bool, std::is_reference<U>::value || is_a2d_view<U>::value ||
+                    std::is_same<typename std::remove_const<U>::type,
+                                 Obj>::value> {};
+
+template <class Obj, template <class...> class Op, class... Args>
+struct __op_references<Obj, Op<Args...>>
+    : std::integral_constant<bool, (op_references<Obj, Args>::value || ...)> {
+};
+
+template <class Obj, template <auto, class...> class Op, auto v,
+          class... Args>
+struct __op_references<Obj, Op<v, Args...>>
+    : std::integral_constant<bool, (op_references<Obj, Args>::value || ...)> {
+};
+
+template <class Obj, template <auto, auto, class...> class Op, auto v1,
+          auto v2, class... Args>
+struct __op_references<Obj, Op<v1, v2, Args...>>
+    : std::integral_constant<bool, (op_references<Obj, Args>::value || ...)> {
+};
+
+template <class Obj, template <class, class, auto> class Op, class A,
+          class B, auto v>
+struct __op_references<Obj, Op<A, B, v>>
+    : std::integral_constant<bool, op_references<Obj, A>::value ||
+                                       op_references<Obj, B>::value> {};
+
+template <class Obj, template <class, class, class, auto> class Op, class A,
+          class B, class C, auto v>
+struct __op_references<Obj, Op<A, B, C, v>>
+    : std::integral_constant<bool, op_references<Obj, A>::value ||
+                                       op_references<Obj, B>::value ||
+                                       op_references<Obj, C>::value> {};
+
 template <class... Operations>
 class OperationStack {
  public:
   using StackTuple = a2d_tuple<Operations...>;
   static constexpr index_t num_ops = sizeof...(Operations);
 
+  // Index of the first operation that may reference A2DObj<Obj>, or num_ops
+  // if there is none. The operations before it don't depend on the object.
+  // Seeds that are not a matrix or vector, such as a tuple of the seeds of
+  // several objects, may be referenced by any operation.
+  template <class Obj>
+  static constexpr index_t first_reference() {
+    if constexpr (!(is_a2d_matrix<Obj>::value ||
+                    is_a2d_sym_matrix<Obj>::value ||
+                    is_a2d_vector<Obj>::value)) {
+      return 0;
+    } else {
+      constexpr bool refs[] = {op_references<Obj, Operations>::value...};
+      for (index_t i = 0; i < num_ops; i++) {
+        if (refs[i]) {
+          return i;
+        }
+      }
+      return num_ops;
+    }
+  }
+
   A2D_FUNCTION OperationStack(Operations &&...s)
       : stack(a2d_forward<Operations>(s)...) {
     eval_<0>();
   }
 
+  // Construct the stack without evaluating it, eval() must be called before
+  // the derivatives
+  A2D_FUNCTION OperationStack(uninit_t, Operations &&...s)
+      : stack(a2d_forward<Operations>(s)...) {}
+
+  // Evaluate the operations again for the current values of the inputs
+  A2D_FUNCTION void eval() { eval_<0>(); }
+
   // First-order AD
   A2D_FUNCTION void bzero() { bzero_<0>(); }
   A2D_FUNCTION void forward() { forward_<0>(); }
@@ -36,29 +134,278 @@ class OperationStack {
     hreverse();
   }
 
-  // Apply Hessian-vector products to extract derivatives
+  // Apply reverse sweeps to extract the Jacobian of the output with respect
+  // to the input, one row per sweep. The seeds of the output and the input
+  // are overwritten.
+  template <class Output, class Input, class Jacobian>
+  A2D_FUNCTION void rextract(Output &ob, Input &ib, Jacobian &jac) {
+    for (index_t i = 0; i < Output::ncomp; i++) {
+      // Zero the seeds that reverse() accumulates into
+      ob.zero();
+      ib.zero();
+      bzero();
+
+      ob[i] = 1.0;
+      reverse();
+
+      for (index_t j = 0; j < Input::ncomp; j++) {
+        jac(i, j) = ib[j];
+      }
+    }
+  }
+
+  /**
+   * @brief Extract the Jacobian K rows at a time with vector reverse mode
+   *
+   * The stack must be built with the lane type simd<T, K>, with the values
+   * the same in every lane. Lane k of the output seed ob carries the unit
+   * vector for row i + k, so each reverse() sweep propagates K adjoints at
+   * once and each core kernel loads the values once for the K seeds. This
+   * takes ceil(ncomp / K) sweeps instead of ncomp.
+   *
+   * @tparam K Number of adjoints per sweep (the lane width)
+   * @param ob Seed of the output
+   * @param ib Seed of the input
+   * @param jac Scalar-valued Jacobian matrix
+   */
+  template <int K, class Output, class Input, class Jacobian>
+  A2D_FUNCTION void rextract_block(Output &ob, Input &ib, Jacobian &jac) {
+    static_assert(get_batch_width<typename Input::type>::width == K &&
+                      get_batch_width<typename Output::type>::width == K,
+                  "rextract_block<K> requires objects with K lanes");
+
+    for (index_t i = 0; i < Output::ncomp; i += K) {
+      ob.zero();
+      ib.zero();
+      bzero();
+
+      for (index_t k = 0; k < K && i + k < Output::ncomp; k++) {
+        ob[i + k][k] = 1.0;
+      }
+      reverse();
+
+      for (index_t k = 0; k < K && i + k < Output::ncomp; k++) {
+        for (index_t j = 0; j < Input::ncomp; j++) {
+          jac(i + k, j) = ib[j][k];
+        }
+      }
+    }
+  }
+
+  // Apply Hessian-vector products to extract derivatives. When the Jacobian
+  // is a SymMat, only the entries on and below the diagonal are stored.
   template <class Input, class Output, class Jacobian>
   A2D_FUNCTION void hextract(Input &p, Output &Jp, Jacobian &jac) {
+    hextract_range(p, Jp, jac, 0, Input::ncomp);
+  }
+
+  /**
+   * @brief Extract the columns [begin, end) of the Jacobian
+   *
+   * The other columns of jac are not modified, so separate stacks over
+   * separate objects, for instance one per thread, can fill disjoint column
+   * ranges of the same Jacobian.
+   *
+   * @param p Direction, the projected seed of the input
+   * @param Jp Product, the second-order seed of the output
+   * @param jac Jacobian matrix, or SymMat for the lower part
+   * @param begin First column
+   * @param end One past the last column
+   */
+  template <class Input, class Output, class Jacobian>
+  A2D_FUNCTION void hextract_range(Input &p, Output &Jp, Jacobian &jac,
+                                   index_t begin, index_t end) {
+    static_assert(!is_a2d_sym_matrix<Jacobian>::value ||
+                      Input::ncomp == Output::ncomp,
+                  "A symmetric Jacobian must be square");
     reverse();
 
-    for (index_t i = 0; i < Input::ncomp; i++) {
-      // Zero all the intermeidate values. This inter object must include the
-      // input values, and all values included.
-      p.zero();
+    // The direction is a unit vector, so only the previous entry needs to be
+    // reset between columns
+    p.zero();
+    hbegin_<Input>();
+    for (index_t i = begin; i < end; i++) {
+      // Zero the seeds that hreverse() accumulates into: the output Jp and
+      // the second-order seeds of the intermediates downstream of it. The
+      // projected seeds are overwritten by hforward().
       Jp.zero();
-      hzero();
+      hzero_from_<Output>();
 
+      if (i > begin) {
+        p[i - 1] = 0.0;
+      }
       p[i] = 1.0;
 
-      // Forward sweep
-      hforward();
+      // Forward sweep from where the input enters
+      hforward_from_<Input>();
+
+      // Reverse sweep down to where the output is first used
+      hreverse_to_<Output>();
+
+      // Extract the column, or its lower part for a symmetric Jacobian
+      if constexpr (is_a2d_sym_matrix<Jacobian>::value) {
+        for (index_t j = i; j < Output::ncomp; j++) {
+          jac[i + j * (j + 1) / 2] = Jp[j];
+        }
+      } else {
+        for (index_t j = 0; j < Output::ncomp; j++) {
+          jac(j, i) = Jp[j];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Extract the Jacobian K columns at a time
+   *
+   * The stack must be built with the lane type simd<T, K>, with the values
+   * and the first-order seeds the same in every lane. Lane k of the direction
+   * p carries the unit vector for column i + k, so each hforward() and
+   * hreverse() sweep computes K columns at once and each core kernel runs on
+   * K directions. This takes ceil(ncomp / K) sweeps instead of ncomp.
+   *
+   * @tparam K Number of directions per sweep (the lane width)
+   * @param p Projected seed of the input
+   * @param Jp Second-order seed of the output
+   * @param jac Scalar-valued Jacobian matrix, lower triangle only for SymMat
+   */
+  template <int K, class Input, class Output, class Jacobian>
+  A2D_FUNCTION void hextract_block(Input &p, Output &Jp, Jacobian &jac) {
+    static_assert(get_batch_width<typename Input::type>::width == K &&
+                      get_batch_width<typename Output::type>::width == K,
+                  "hextract_block<K> requires objects with K lanes");
+    static_assert(!is_a2d_sym_matrix<Jacobian>::value ||
+                      Input::ncomp == Output::ncomp,
+                  "A symmetric Jacobian must be square");
+    reverse();
+
+    p.zero();
+    hbegin_<Input>();
+    for (index_t i = 0; i < Input::ncomp; i += K) {
+      Jp.zero();
+      hzero_from_<Output>();
+
+      // Reset the previous block and set the unit directions in the lanes
+      for (index_t k = 0; k < K; k++) {
+        if (i >= K) {
+          p[i - K + k][k] = 0.0;
+        }
+        if (i + k < Input::ncomp) {
+          p[i + k][k] = 1.0;
+        }
+      }
+
+      hforward_from_<Input>();
+      hreverse_to_<Output>();
+
+      for (index_t k = 0; k < K && i + k < Input::ncomp; k++) {
+        if constexpr (is_a2d_sym_matrix<Jacobian>::value) {
+          for (index_t j = i + k; j < Output::ncomp; j++) {
+            jac[i + k + j * (j + 1) / 2] = Jp[j][k];
+          }
+        } else {
+          for (index_t j = 0; j < Output::ncomp; j++) {
+            jac(j, i + k) = Jp[j][k];
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Compute the nonzero pattern of the Jacobian and color its columns
+   *
+   * Each direction is seeded with NaN, which propagates along every data
+   * path from the input to the output regardless of the values, so the
+   * pattern is structural: an entry is nonzero when the output component
+   * depends on the input component through the operations on the stack.
+   * This takes one sweep per input component and only needs to be done once
+   * per stack.
+   *
+   * @param p Projected seed of the input
+   * @param Jp Second-order seed of the output
+   * @param pattern The nonzero pattern and column coloring
+   */
+  template <class Input, class Output, index_t M, index_t N>
+  A2D_FUNCTION void hpattern(Input &p, Output &Jp,
+                             JacobianPattern<M, N> &pattern) {
+    static_assert(Input::ncomp == N && Output::ncomp == M,
+                  "The pattern size must match the input and output");
+    using T = typename Input::type;
+    reverse();
+
+    p.zero();
+    hbegin_<Input>();
+    for (index_t i = 0; i < N; i++) {
+      Jp.zero();
+      hzero_from_<Output>();
+
+      if (i > 0) {
+        p[i - 1] = 0.0;
+      }
+      p[i] = T(std::numeric_limits<double>::quiet_NaN());
+
+      hforward_from_<Input>();
+      hreverse_to_<Output>();
+
+      for (index_t j = 0; j < M; j++) {
+        double value = RealPart(Jp[j]);
+        pattern(j, i) = (value != value);
+      }
+    }
+    p.zero();
+    Jp.zero();
+    hzero();
+
+    pattern.color_columns();
+  }
+
+  /**
+   * @brief Extract the Jacobian with one sweep per color of the pattern
+   *
+   * The entries outside the pattern are set to zero. When the Jacobian is a
+   * SymMat, only the entries on and below the diagonal are stored.
+   *
+   * @param pattern The pattern computed by hpattern()
+   * @param p Projected seed of the input
+   * @param Jp Second-order seed of the output
+   * @param jac Jacobian matrix
+   */
+  template <class Input, class Output, index_t M, index_t N, class Jacobian>
+  A2D_FUNCTION void hextract_compressed(const JacobianPattern<M, N> &pattern,
+                                        Input &p, Output &Jp, Jacobian &jac) {
+    static_assert(Input::ncomp == N && Output::ncomp == M,
+                  "The pattern size must match the input and output");
+    static_assert(!is_a2d_sym_matrix<Jacobian>::value || M == N,
+                  "A symmetric Jacobian must be square");
+    reverse();
+    hbegin_<Input>();
+
+    for (index_t c = 0; c < pattern.num_colors; c++) {
+      Jp.zero();
+      hzero_from_<Output>();
 
-      // Reverse sweep
-      hreverse();
+      // The direction is the sum of the unit vectors of the columns
+      for (index_t i = 0; i < N; i++) {
+        p[i] = (pattern.color[i] == c ? 1.0 : 0.0);
+      }
+
+      hforward_from_<Input>();
+      hreverse_to_<Output>();
 
-      // Extract the number of columns
-      for (index_t j = 0; j < Output::ncomp; j++) {
-        jac(j, i) = Jp[j];
+      for (index_t i = 0; i < N; i++) {
+        if (pattern.color[i] != c) {
+          continue;
+        }
+        if constexpr (is_a2d_sym_matrix<Jacobian>::value) {
+          for (index_t j = i; j < M; j++) {
+            jac[i + j * (j + 1) / 2] = (pattern(j, i) ? Jp[j] : 0.0);
+          }
+        } else {
+          for (index_t j = 0; j < M; j++) {
+            jac(j, i) = (pattern(j, i) ? Jp[j] : 0.0);
+          }
+        }
       }
     }
   }
@@ -106,19 +453,62 @@ class OperationStack {
     }
   }
 
-  template <index_t index>
+  template <index_t index, index_t end = num_ops>
   A2D_FUNCTION void hforward_() {
     a2d_get<index>(stack).template forward<ADorder::SECOND>();
-    if constexpr (index < num_ops - 1) {
-      hforward_<index + 1>();
+    if constexpr (index < end - 1) {
+      hforward_<index + 1, end>();
     }
   }
 
-  template <index_t index>
+  template <index_t index, index_t first = 0>
   A2D_FUNCTION void hreverse_() {
     a2d_get<index>(stack).hreverse();
-    if constexpr (index) {
-      hreverse_<index - 1>();
+    if constexpr (index > first) {
+      hreverse_<index - 1, first>();
+    }
+  }
+
+  /*
+    Second-order sweeps for extracting the derivatives of A2DObj<Output> with
+    respect to A2DObj<Input>, one direction at a time.
+
+    The operations before the first one that references the input don't
+    depend on the direction, so their projected seeds are computed once by
+    hbegin_() and hforward_from_() only runs the operations from there on.
+    Only the operations from the first one that references the output can
+    contribute to its second-order seed, so hzero_from_() and hreverse_to_()
+    skip the operations before it.
+  */
+  template <class Input>
+  A2D_FUNCTION void hbegin_() {
+    constexpr index_t first = first_reference<Input>();
+    if constexpr (first > 0) {
+      hforward_<0, first>();
+    }
+  }
+
+  template <class Output>
+  A2D_FUNCTION void hzero_from_() {
+    constexpr index_t first = first_reference<Output>();
+    if constexpr (first < num_ops) {
+      hzero_<first>();
+    }
+  }
+
+  template <class Input>
+  A2D_FUNCTION void hforward_from_() {
+    constexpr index_t first = first_reference<Input>();
+    if constexpr (first < num_ops) {
+      hforward_<first>();
+    }
+  }
+
+  template <class Output>
+  A2D_FUNCTION void hreverse_to_() {
+    constexpr index_t first = first_reference<Output>();
+    if constexpr (first < num_ops) {
+      hreverse_<num_ops - 1, first>();
     }
   }
 };
@@ -137,6 +527,187 @@ A2D_FUNCTION auto MakeStack(Operations &&...s) {
   return OperationStack<Operations...>(a2d_forward<Operations>(s)...);
 }
 
+/**
+ * @brief Make an operations stack that is not evaluated on construction
+ *
+ * @tparam Operations Template parameter list deduced from context
+ * @param s The operator objects
+ * @return The list of operations
+ */
+template <class... Operations>
+A2D_FUNCTION auto MakeStack(uninit_t, Operations &&...s) {
+  return OperationStack<Operations...>(uninit, a2d_forward<Operations>(s)...);
+}
+
+/**
+ * @brief A stack of operations that owns its objects and can be evaluated
+ * again for new inputs
+ *
+ * The plan stores the objects, inputs and intermediates, and builds the stack
+ * once by calling builder(objects...), which must return the stack from
+ * MakeStack(uninit, ...). For each new point, the inputs are updated, either
+ * by rebind() for objects of views or by setting their values, and eval()
+ * evaluates the operations without reconstructing anything.
+ *
+ * The stack holds references to the objects of the plan, so the plan can't
+ * be copied or moved.
+ *
+ * @tparam Builder Callable that makes the stack from the objects
+ * @tparam Objects The objects, e.g. A2DObj<MatView<T, 3, 3>>
+ */
+template <class Builder, class... Objects>
+class StackPlan {
+ public:
+  using Stack =
+      decltype(std::declval<Builder &>()(std::declval<Objects &>()...));
+  static constexpr index_t num_objects = sizeof...(Objects);
+
+  A2D_FUNCTION StackPlan(Builder builder)
+      : stack(build(builder, std::make_index_sequence<num_objects>())) {}
+
+  StackPlan(const StackPlan &) = delete;
+  StackPlan &operator=(const StackPlan &) = delete;
+
+  // Access the objects and the stack
+  template <index_t index>
+  A2D_FUNCTION auto &get() {
+    return a2d_get<index>(objects);
+  }
+  A2D_FUNCTION Stack &get_stack() { return stack; }
+
+  /**
+   * @brief Point the views of an object at new data
+   *
+   * The seeds that are not needed can be left as nullptr and keep their
+   * current data
+   *
+   * @tparam index Index of the object
+   * @param value Pointer to the value
+   * @param bvalue Pointer to the reverse mode seed
+   * @param pvalue Pointer to the projected seed (A2DObj only)
+   * @param hvalue Pointer to the second-order reverse seed (A2DObj only)
+   */
+  template <index_t index, typename T>
+  A2D_FUNCTION void rebind(T *value, T *bvalue = nullptr, T *pvalue = nullptr,
+                           T *hvalue = nullptr) {
+    auto &obj = a2d_get<index>(objects);
+    static_assert(is_a2d_view<typename remove_const_and_refs<
+                      decltype(obj.value())>::type>::value,
+                  "rebind() requires an object of views");
+    obj.value().rebind(value);
+    if (bvalue) {
+      obj.bvalue().rebind(bvalue);
+    }
+    if constexpr (get_diff_order<typename remove_const_and_refs<
+                      decltype(obj)>::type>::order == ADorder::SECOND) {
+      if (pvalue) {
+        obj.pvalue().rebind(pvalue);
+      }
+      if (hvalue) {
+        obj.hvalue().rebind(hvalue);
+      }
+    }
+  }
+
+  // Evaluate the operations for the current inputs
+  A2D_FUNCTION void eval() { stack.eval(); }
+
+ private:
+  a2d_tuple<Objects...> objects;
+  Stack stack;
+
+  template <std::size_t... I>
+  A2D_FUNCTION Stack build(Builder &builder, std::index_sequence<I...>) {
+    return builder(a2d_get<I>(objects)...);
+  }
+};
+
+/**
+ * @brief Make a stack plan that owns the objects
+ *
+ * @tparam Objects The objects, inputs and intermediates
+ * @param builder Callable that makes the stack from the objects
+ * @return The stack plan
+ */
+template <class... Objects, class Builder>
+A2D_FUNCTION auto MakeStackPlan(Builder builder) {
+  return StackPlan<Builder, Objects...>(builder);
+}
+
+/*
+  Pairs of adjacent operations that MakeFusedStack replaces with a single
+  operation. Specializations derive from std::true_type and define the fused
+  operation type, constructible from the two operations, and the type
+  intermediate of the object whose seeds the fused operation doesn't compute.
+*/
+template <class A, class B, class Enable = void>
+struct fused_operation : std::false_type {};
+
+/*
+  Whether the pair recognized by Fused can be fused when it is followed by the
+  operations Rest. The fusion is refused when a later operation may reference
+  an object of the intermediate type, since its seeds would be dropped.
+*/
+template <class Fused, class... Rest>
+constexpr bool can_fuse_operations() {
+  if constexpr (Fused::value) {
+    return !(op_references<typename Fused::intermediate, Rest>::value || ...);
+  } else {
+    return false;
+  }
+}
+
+/*
+  Build the stack from the operations, fusing the pairs of adjacent
+  operations recognized by fused_operation from left to right. Done is the
+  list of operations already placed in the stack.
+*/
+template <class... Done>
+struct __fused_stack_builder {
+  A2D_FUNCTION static auto make(Done &&...done) {
+    return OperationStack<Done...>(a2d_forward<Done>(done)...);
+  }
+
+  template <class A>
+  A2D_FUNCTION static auto make(Done &&...done, A &&a) {
+    return __fused_stack_builder<Done..., A>::make(a2d_forward<Done>(done)...,
+                                                   a2d_forward<A>(a));
+  }
+
+  template <class A, class B, class... Rest>
+  A2D_FUNCTION static auto make(Done &&...done, A &&a, B &&b,
+                                Rest &&...rest) {
+    using Fused = fused_operation<typename remove_const_and_refs<A>::type,
+                                  typename remove_const_and_refs<B>::type>;
+    if constexpr (can_fuse_operations<Fused, Rest...>()) {
+      using F = typename Fused::type;
+      return __fused_stack_builder<Done..., F>::make(
+          a2d_forward<Done>(done)..., F(a, b), a2d_forward<Rest>(rest)...);
+    } else {
+      return __fused_stack_builder<Done..., A>::make(
+          a2d_forward<Done>(done)..., a2d_forward<A>(a), a2d_forward<B>(b),
+          a2d_forward<Rest>(rest)...);
+    }
+  }
+};
+
+/**
+ * @brief Make an operations stack, fusing recognized pairs of adjacent
+ * operations
+ *
+ * A fused operation computes the same output and derivatives as the pair,
+ * but doesn't compute the seeds of the intermediate that connects them.
+ * Operations are evaluated immediately on construction
+ *
+ * @tparam Operations Template parameter list deduced from context
+ * @param s The operator objects
+ * @return The list of operations
+ */
+template <class... Operations>
+A2D_FUNCTION auto MakeFusedStack(Operations &&...s) {
+  return __fused_stack_builder<>::make(a2d_forward<Operations>(s)...);
+}
+
 /**
  * @brief Compute the Jacobian-vector product depending on the input/output
  * states
@@ -227,6 +798,190 @@ A2D_FUNCTION void ExtractJacobian(OperationStack<Operations...> &stack,
   }
 }
 
+/**
+ * @brief Compute the nonzero pattern of the Jacobian and color its columns
+ * depending on the input/output state
+ *
+ * @tparam of Residual type
+ * @tparam wrt Derivative type
+ * @tparam Data Deduced data space type
+ * @tparam Geo Deduced geometry space type
+ * @tparam State Deduced state space type
+ * @tparam Operations variadic template of operations
+ * @param stack Stack of operations
+ * @param data Data object
+ * @param geo Geometry object
+ * @param state State space object
+ * @param pattern Output pattern of the Jacobian
+ */
+template <FEVarType of, FEVarType wrt, class Data, class Geo, class State,
+          index_t M, index_t N, class... Operations>
+A2D_FUNCTION void ExtractJacobianPattern(OperationStack<Operations...> &stack,
+                                         A2DObj<Data> &data, A2DObj<Geo> &geo,
+                                         A2DObj<State> &state,
+                                         JacobianPattern<M, N> &pattern) {
+  if constexpr (of == FEVarType::DATA) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hpattern(data.pvalue(), data.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hpattern(geo.pvalue(), data.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hpattern(state.pvalue(), data.hvalue(), pattern);
+    }
+  } else if constexpr (of == FEVarType::GEOMETRY) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hpattern(data.pvalue(), geo.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hpattern(geo.pvalue(), geo.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hpattern(state.pvalue(), geo.hvalue(), pattern);
+    }
+  } else if constexpr (of == FEVarType::STATE) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hpattern(data.pvalue(), state.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hpattern(geo.pvalue(), state.hvalue(), pattern);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hpattern(state.pvalue(), state.hvalue(), pattern);
+    }
+  }
+}
+
+/**
+ * @brief Extract the Jacobian matrix with one vector-product per color of a
+ * pattern computed by ExtractJacobianPattern
+ *
+ * @tparam of Residual type
+ * @tparam wrt Derivative type
+ * @tparam Data Deduced data space type
+ * @tparam Geo Deduced geometry space type
+ * @tparam State Deduced state space type
+ * @tparam MatType Deduced Jacobian matrix type
+ * @tparam Operations variadic template of operations
+ * @param stack Stack of operations
+ * @param data Data object
+ * @param geo Geometry object
+ * @param state State space object
+ * @param pattern Pattern of the Jacobian
+ * @param jac Output Jacobian matrix
+ */
+template <FEVarType of, FEVarType wrt, class Data, class Geo, class State,
+          index_t M, index_t N, class MatType, class... Operations>
+A2D_FUNCTION void ExtractJacobian(OperationStack<Operations...> &stack,
+                                  A2DObj<Data> &data, A2DObj<Geo> &geo,
+                                  A2DObj<State> &state,
+                                  const JacobianPattern<M, N> &pattern,
+                                  MatType &jac) {
+  if constexpr (of == FEVarType::DATA) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hextract_compressed(pattern, data.pvalue(), data.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hextract_compressed(pattern, geo.pvalue(), data.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hextract_compressed(pattern, state.pvalue(), data.hvalue(), jac);
+    }
+  } else if constexpr (of == FEVarType::GEOMETRY) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hextract_compressed(pattern, data.pvalue(), geo.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hextract_compressed(pattern, geo.pvalue(), geo.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hextract_compressed(pattern, state.pvalue(), geo.hvalue(), jac);
+    }
+  } else if constexpr (of == FEVarType::STATE) {
+    if constexpr (wrt == FEVarType::DATA) {
+      stack.hextract_compressed(pattern, data.pvalue(), state.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::GEOMETRY) {
+      stack.hextract_compressed(pattern, geo.pvalue(), state.hvalue(), jac);
+    } else if constexpr (wrt == FEVarType::STATE) {
+      stack.hextract_compressed(pattern, state.pvalue(), state.hvalue(), jac);
+    }
+  }
+}
+
+/**
+ * @brief Jacobian of a stack recorded at a fixed linearization point
+ *
+ * linearize() extracts the Jacobian once with ExtractJacobian. Each call to
+ * product() or JacobianProduct() afterwards is a dense matrix-vector product
+ * with the stored Jacobian, with no sweeps through the stack. This pays off
+ * when many products are needed at the same point, as in the iterations of
+ * a Krylov solver within a Newton step.
+ *
+ * The Jacobian is stored as a dense transpose, so that the product is a
+ * sequence of contiguous axpy updates that the compiler can vectorize.
+ *
+ * @tparam of Residual type
+ * @tparam wrt Derivative type
+ * @tparam MatType Jacobian matrix type for ExtractJacobian
+ */
+template <FEVarType of, FEVarType wrt, class MatType>
+class LinearizedJacobian {
+ public:
+  using T = typename get_object_numeric_type<MatType>::type;
+  static constexpr index_t nrows = MatType::nrows;
+  static constexpr index_t ncols = MatType::ncols;
+
+  // Record the Jacobian with one sweep per column
+  template <class Data, class Geo, class State, class... Operations>
+  A2D_FUNCTION void linearize(OperationStack<Operations...> &stack,
+                              A2DObj<Data> &data, A2DObj<Geo> &geo,
+                              A2DObj<State> &state) {
+    MatType jac;
+    ExtractJacobian<of, wrt>(stack, data, geo, state, jac);
+    set_jacobian(jac);
+  }
+
+  // Record the Jacobian with one sweep per color of the pattern
+  template <class Data, class Geo, class State, index_t M, index_t N,
+            class... Operations>
+  A2D_FUNCTION void linearize(OperationStack<Operations...> &stack,
+                              A2DObj<Data> &data, A2DObj<Geo> &geo,
+                              A2DObj<State> &state,
+                              const JacobianPattern<M, N> &pattern) {
+    MatType jac;
+    ExtractJacobian<of, wrt>(stack, data, geo, state, pattern, jac);
+    set_jacobian(jac);
+  }
+
+  // Store a Jacobian computed elsewhere
+  A2D_FUNCTION void set_jacobian(const MatType &jac) {
+    for (index_t i = 0; i < nrows; i++) {
+      for (index_t j = 0; j < ncols; j++) {
+        jacT(j, i) = jac(i, j);
+      }
+    }
+  }
+
+  // Compute res = J * p with the recorded Jacobian
+  template <class PType, class RType>
+  A2D_FUNCTION void product(const PType &p, RType &res) const {
+    static_assert(PType::ncomp == ncols && RType::ncomp == nrows,
+                  "The vector sizes must match the Jacobian");
+    MatVecCore<T, ncols, nrows, MatOp::TRANSPOSE>(
+        jacT.get_data(), p.get_data(), res.get_data());
+  }
+
+ private:
+  Mat<T, ncols, nrows> jacT;
+};
+
+/**
+ * @brief Compute the Jacobian-vector product with a Jacobian recorded by
+ * LinearizedJacobian::linearize()
+ *
+ * @param jac The linearized Jacobian
+ * @param p Direction vector - same type as wrt
+ * @param res Result vector - same type as of
+ */
+template <FEVarType of, FEVarType wrt, class MatType, class PType,
+          class RType>
+A2D_FUNCTION void JacobianProduct(
+    const LinearizedJacobian<of, wrt, MatType> &jac, const PType &p,
+    RType &res) {
+  jac.product(p, res);
+}
+
 }  // namespace A2D
 
 #endif  // A2D_STACK_H
@@ -0,0 +1,414 @@
+#ifndef A2D_SYM_CHOL_H
+#define A2D_SYM_CHOL_H
+
+#include <type_traits>
+
+#include "../a2ddefs.h"
+#include "a2dmat.h"
+#include "a2dobj.h"
+#include "a2dstack.h"
+#include "a2dtest.h"
+#include "a2dvec.h"
+#include "core/a2dsymcholcore.h"
+
+namespace A2D {
+
+/*
+  Compute the Cholesky factor S = L * L^{T} of a symmetric positive definite
+  matrix
+
+  The lower-triangular factor L is returned in a SymMat using the same packed
+  storage as S. Note that L is not symmetric: only CholSolve() interprets it
+  as the triangular factor.
+
+  dot{L} = L * Phi(L^{-1} * dot{S} * L^{-T})
+
+  Sb = L^{-T} * Phi(L^{T} * Lb) * L^{-1}
+
+  where Phi() takes the lower triangle and halves the diagonal.
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholesky(const SymMat<T, N>& S, SymMat<T, N>& L) {
+  SymMatCholFactorCore<T, N>(get_data(S), get_data(L));
+}
+
+/*
+  Solve L * L^{T} * x = b given the packed Cholesky factor L
+*/
+template <typename T, int N>
+A2D_FUNCTION void CholSolve(const SymMat<T, N>& L, const Vec<T, N>& b,
+                            Vec<T, N>& x) {
+  SymMatCholSolveCore<T, N>(get_data(L), get_data(b), get_data(x));
+}
+
+template <class Stype, class Ltype>
+class SymMatCholeskyExpr {
+ public:
+  // Extract the numeric type to use
+  typedef typename get_object_numeric_type<Ltype>::type T;
+
+  // Extract the dimensions of the matrices
+  static constexpr int N = get_symmatrix_size<Stype>::size;
+  static constexpr int M = get_symmatrix_size<Ltype>::size;
+  static_assert(N == M, "Matrix dimensions must agree");
+
+  // Get the differentiation order from the output
+  static constexpr ADorder order = get_diff_order<Ltype>::order;
+
+  // Make sure that the order is correct
+  static_assert(get_diff_order<Stype>::order == order,
+                "ADorder does not match");
+
+  A2D_FUNCTION SymMatCholeskyExpr(Stype& S, Ltype& L) : S(S), L(L) {}
+
+  A2D_FUNCTION void eval() {
+    SymMatCholFactorCore<T, N>(get_data(S), get_data(L));
+  }
+
+  A2D_FUNCTION void bzero() { L.bzero(); }
+
+  template <ADorder forder>
+  A2D_FUNCTION void forward() {
+    static_assert(
+        !(order == ADorder::FIRST and forder == ADorder::SECOND),
+        "Can't perform second order forward with first order objects");
+    constexpr ADseed seed = conditional_value<ADseed, forder == ADorder::FIRST,
+                                              ADseed::b, ADseed::p>::value;
+    SymMatCholForwardCore<T, N>(get_data(L), GetSeed<seed>::get_data(S),
+                                GetSeed<seed>::get_data(L));
+  }
+
+  A2D_FUNCTION void reverse() {
+    SymMatCholReverseCore<T, N>(get_data(L), GetSeed<ADseed::b>::get_data(L),
+                                GetSeed<ADseed::b>::get_data(S));
+  }
+
+  A2D_FUNCTION void hzero() { L.hzero(); }
+
+  A2D_FUNCTION void hreverse() {
+    static_assert(order == ADorder::SECOND,
+                  "hreverse() can be called for only second order objects.");
+    SymMatCholHReverseCore<T, N>(
+        get_data(L), GetSeed<ADseed::p>::get_data(L),
+        GetSeed<ADseed::b>::get_data(L), GetSeed<ADseed::h>::get_data(L),
+        GetSeed<ADseed::h>::get_data(S));
+  }
+
+ private:
+  Stype& S;
+  Ltype& L;
+};
+
+template <class Stype, class Ltype>
+A2D_FUNCTION auto SymMatCholesky(ADObj<Stype>& S, ADObj<Ltype>& L) {
+  return SymMatCholeskyExpr<ADObj<Stype>, ADObj<Ltype>>(S, L);
+}
+
+template <class Stype, class Ltype>
+A2D_FUNCTION auto SymMatCholesky(A2DObj<Stype>& S, A2DObj<Ltype>& L) {
+  return SymMatCholeskyExpr<A2DObj<Stype>, A2DObj<Ltype>>(S, L);
+}
+
+/*
+  Solve S * x = b with S = L * L^{T}
+
+  With y = L^{T} * x and z = L^{T} * w, where w = S^{-1} * xb,
+
+  dot{x} = S^{-1} * (dot{b} - dot{L} * y - L * dot{L}^{T} * x)
+
+  bb = w,  Lb = - tril(w * y^{T} + x * z^{T})
+*/
+template <class Ltype, class btype, class xtype>
+class CholSolveExpr {
+ public:
+  // Extract the numeric type to use
+  typedef typename get_object_numeric_type<xtype>::type T;
+
+  // Extract the dimensions of the matrix and vectors
+  static constexpr int N = get_symmatrix_size<Ltype>::size;
+  static constexpr int K = get_vec_size<btype>::size;
+  static constexpr int P = get_vec_size<xtype>::size;
+
+  static_assert(N == K && N == P, "Matrix and vector dimensions must agree");
+
+  // Get the types of the inputs
+  static constexpr ADiffType adL = get_diff_type<Ltype>::diff_type;
+  static constexpr ADiffType adb = get_diff_type<btype>::diff_type;
+
+  // Get the differentiation order from the output
+  static constexpr ADorder order = get_diff_order<xtype>::order;
+
+  A2D_FUNCTION CholSolveExpr(Ltype& L, btype& b, xtype& x) : L(L), b(b), x(x) {}
+
+  A2D_FUNCTION void eval() {
+    SymMatCholSolveCore<T, N>(get_data(L), get_data(b), get_data(x));
+  }
+
+  A2D_FUNCTION void bzero() { x.bzero(); }
+
+  template <ADorder forder>
+  A2D_FUNCTION void forward() {
+    static_assert(
+        !(order == ADorder::FIRST and forder == ADorder::SECOND),
+        "Can't perform second order forward with first order objects");
+    constexpr ADseed seed = conditional_value<ADseed, forder == ADorder::FIRST,
+                                              ADseed::b, ADseed::p>::value;
+
+    // r = dot{b} - dot{L} * L^{T} * x - L * dot{L}^{T} * x
+    T r[N];
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecCopyCore<T, N>(GetSeed<seed>::get_data(b), r);
+    } else {
+      VecZeroCore<T, N>(r);
+    }
+    if constexpr (adL == ADiffType::ACTIVE) {
+      T y[N], t[N];
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), get_data(x), y);
+      SymMatCholMultCore<T, N>(GetSeed<seed>::get_data(L), y, t);
+      VecAddCore<T, N>(T(-1.0), t, r);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(GetSeed<seed>::get_data(L),
+                                                 get_data(x), y);
+      SymMatCholMultCore<T, N>(get_data(L), y, t);
+      VecAddCore<T, N>(T(-1.0), t, r);
+    }
+    SymMatCholSolveCore<T, N>(get_data(L), r, GetSeed<seed>::get_data(x));
+  }
+
+  A2D_FUNCTION void reverse() {
+    T w[N];
+    SymMatCholSolveCore<T, N>(get_data(L), GetSeed<ADseed::b>::get_data(x), w);
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(w, GetSeed<ADseed::b>::get_data(b));
+    }
+    if constexpr (adL == ADiffType::ACTIVE) {
+      T y[N], z[N];
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), get_data(x), y);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), w, z);
+      SymMatCholOuterAddCore<T, N>(T(-1.0), w, y,
+                                   GetSeed<ADseed::b>::get_data(L));
+      SymMatCholOuterAddCore<T, N>(T(-1.0), get_data(x), z,
+                                   GetSeed<ADseed::b>::get_data(L));
+    }
+  }
+
+  A2D_FUNCTION void hzero() { x.hzero(); }
+
+  A2D_FUNCTION void hreverse() {
+    static_assert(order == ADorder::SECOND,
+                  "hreverse() can be called for only second order objects.");
+
+    // wh = S^{-1} * (xh - Sp * w), where Sp = Lp * L^{T} + L * Lp^{T}
+    T w[N], r[N], wh[N];
+    VecCopyCore<T, N>(GetSeed<ADseed::h>::get_data(x), r);
+    if constexpr (adL == ADiffType::ACTIVE) {
+      SymMatCholSolveCore<T, N>(get_data(L), GetSeed<ADseed::b>::get_data(x),
+                                w);
+      T t[N], s[N];
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), w, t);
+      SymMatCholMultCore<T, N>(GetSeed<ADseed::p>::get_data(L), t, s);
+      VecAddCore<T, N>(T(-1.0), s, r);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(
+          GetSeed<ADseed::p>::get_data(L), w, t);
+      SymMatCholMultCore<T, N>(get_data(L), t, s);
+      VecAddCore<T, N>(T(-1.0), s, r);
+    }
+    SymMatCholSolveCore<T, N>(get_data(L), r, wh);
+
+    if constexpr (adb == ADiffType::ACTIVE) {
+      VecAddCore<T, N>(wh, GetSeed<ADseed::h>::get_data(b));
+    }
+    if constexpr (adL == ADiffType::ACTIVE) {
+      const T* Lp = GetSeed<ADseed::p>::get_data(L);
+      const T* xp = GetSeed<ADseed::p>::get_data(x);
+      T* Lh = GetSeed<ADseed::h>::get_data(L);
+
+      // y = L^{T} * x, yp = Lp^{T} * x + L^{T} * xp
+      // z = L^{T} * w, zh = L^{T} * wh + Lp^{T} * w
+      T y[N], yp[N], z[N], zh[N], t[N];
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), get_data(x), y);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(Lp, get_data(x), yp);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), xp, t);
+      VecAddCore<T, N>(t, yp);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), w, z);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(get_data(L), wh, zh);
+      SymMatCholMultCore<T, N, MatOp::TRANSPOSE>(Lp, w, t);
+      VecAddCore<T, N>(t, zh);
+
+      // Lh -= tril(wh * y^{T} + w * yp^{T} + xp * z^{T} + x * zh^{T})
+      SymMatCholOuterAddCore<T, N>(T(-1.0), wh, y, Lh);
+      SymMatCholOuterAddCore<T, N>(T(-1.0), w, yp, Lh);
+      SymMatCholOuterAddCore<T, N>(T(-1.0), xp, z, Lh);
+      SymMatCholOuterAddCore<T, N>(T(-1.0), get_data(x), zh, Lh);
+    }
+  }
+
+ private:
+  Ltype& L;
+  btype& b;
+  xtype& x;
+};
+
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(ADObj<Ltype>& L, ADObj<btype>& b, ADObj<xtype>& x) {
+  return CholSolveExpr<ADObj<Ltype>, ADObj<btype>, ADObj<xtype>>(L, b, x);
+}
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(A2DObj<Ltype>& L, A2DObj<btype>& b,
+                            A2DObj<xtype>& x) {
+  return CholSolveExpr<A2DObj<Ltype>, A2DObj<btype>, A2DObj<xtype>>(L, b, x);
+}
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(ADObj<Ltype>& L, const btype& b, ADObj<xtype>& x) {
+  return CholSolveExpr<ADObj<Ltype>, const btype, ADObj<xtype>>(L, b, x);
+}
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(A2DObj<Ltype>& L, const btype& b,
+                            A2DObj<xtype>& x) {
+  return CholSolveExpr<A2DObj<Ltype>, const btype, A2DObj<xtype>>(L, b, x);
+}
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(const Ltype& L, ADObj<btype>& b, ADObj<xtype>& x) {
+  return CholSolveExpr<const Ltype, ADObj<btype>, ADObj<xtype>>(L, b, x);
+}
+template <class Ltype, class btype, class xtype>
+A2D_FUNCTION auto CholSolve(const Ltype& L, A2DObj<btype>& b,
+                            A2DObj<xtype>& x) {
+  return CholSolveExpr<const Ltype, A2DObj<btype>, A2DObj<xtype>>(L, b, x);
+}
+
+namespace Test {
+
+// Generate a positive definite matrix from the test input
+template <typename T, int N>
+void CholTestMakeSPD(SymMat<T, N>& S) {
+  for (int i = 0; i < N; i++) {
+    S(i, i) += 2.0 * N;
+  }
+}
+
+template <typename T, int N>
+class SymMatCholeskyTest : public A2DTest<T, SymMat<T, N>, SymMat<T, N>> {
+ public:
+  using Input = VarTuple<T, SymMat<T, N>>;
+  using Output = VarTuple<T, SymMat<T, N>>;
+
+  // Assemble a string to describe the test
+  std::string name() {
+    std::stringstream s;
+    s << "SymMatCholesky<" << N << ">";
+    return s.str();
+  }
+
+  // Evaluate the factorization
+  Output eval(const Input& x) {
+    SymMat<T, N> S, L;
+    x.get_values(S);
+    CholTestMakeSPD(S);
+    SymMatCholesky(S, L);
+    return MakeVarTuple<T>(L);
+  }
+
+  // Compute the derivative
+  void deriv(const Output& seed, const Input& x, Input& g) {
+    ADObj<SymMat<T, N>> S, L;
+    x.get_values(S.value());
+    CholTestMakeSPD(S.value());
+    auto stack = MakeStack(SymMatCholesky(S, L));
+    seed.get_values(L.bvalue());
+    stack.reverse();
+    g.set_values(S.bvalue());
+  }
+
+  // Compute the second-derivative
+  void hprod(const Output& seed, const Output& hval, const Input& x,
+             const Input& p, Input& h) {
+    A2DObj<SymMat<T, N>> S, L;
+    x.get_values(S.value());
+    CholTestMakeSPD(S.value());
+    p.get_values(S.pvalue());
+    auto stack = MakeStack(SymMatCholesky(S, L));
+    seed.get_values(L.bvalue());
+    hval.get_values(L.hvalue());
+    stack.hproduct();
+    h.set_values(S.hvalue());
+  }
+};
+
+template <typename T, int N>
+class CholSolveTest
+    : public A2DTest<T, Vec<T, N>, SymMat<T, N>, Vec<T, N>> {
+ public:
+  using Input = VarTuple<T, SymMat<T, N>, Vec<T, N>>;
+  using Output = VarTuple<T, Vec<T, N>>;
+
+  // Assemble a string to describe the test
+  std::string name() {
+    std::stringstream s;
+    s << "CholSolve<" << N << ">";
+    return s.str();
+  }
+
+  // Evaluate the solution, the factor is given by the lower triangle of the
+  // input with a shifted diagonal
+  Output eval(const Input& X) {
+    SymMat<T, N> L;
+    Vec<T, N> b, x;
+    X.get_values(L, b);
+    CholTestMakeSPD(L);
+    CholSolve(L, b, x);
+    return MakeVarTuple<T>(x);
+  }
+
+  // Compute the derivative
+  void deriv(const Output& seed, const Input& X, Input& g) {
+    ADObj<SymMat<T, N>> L;
+    ADObj<Vec<T, N>> b, x;
+    X.get_values(L.value(), b.value());
+    CholTestMakeSPD(L.value());
+    auto stack = MakeStack(CholSolve(L, b, x));
+    seed.get_values(x.bvalue());
+    stack.reverse();
+    g.set_values(L.bvalue(), b.bvalue());
+  }
+
+  // Compute the second-derivative
+  void hprod(const Output& seed, const Output& hval, const Input& X,
+             const Input& p, Input& h) {
+    A2DObj<SymMat<T, N>> L;
+    A2DObj<Vec<T, N>> b, x;
+    X.get_values(L.value(), b.value());
+    CholTestMakeSPD(L.value());
+    p.get_values(L.pvalue(), b.pvalue());
+    auto stack = MakeStack(CholSolve(L, b, x));
+    seed.get_values(x.bvalue());
+    hval.get_values(x.hvalue());
+    stack.hproduct();
+    h.set_values(L.hvalue(), b.hvalue());
+  }
+};
+
+inline bool SymMatCholeskyTestAll(bool component = false,
+                                  bool write_output = true) {
+  using Tc = A2D_complex_t<double>;
+
+  bool passed = true;
+  SymMatCholeskyTest<Tc, 1> test1;
+  passed = passed && Run(test1, component, write_output);
+  SymMatCholeskyTest<Tc, 3> test2;
+  passed = passed && Run(test2, component, write_output);
+  SymMatCholeskyTest<Tc, 5> test3;
+  passed = passed && Run(test3, component, write_output);
+
+  CholSolveTest<Tc, 2> test4;
+  passed = passed && Run(test4, component, write_output);
+  CholSolveTest<Tc, 4> test5;
+  passed = passed && Run(test5, component, write_output);
+
+  return passed;
+}
+
+}  // namespace Test
+
+}  // namespace A2D
+
+#endif  // A2D_SYM_CHOL_H
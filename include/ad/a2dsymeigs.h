@@ -2,6 +2,13 @@
 #define A2D_SYM_MAT_EIGS_H
 
 #include "../a2ddefs.h"
+#include "a2dmat.h"
+#include "a2dobj.h"
+#include "a2dstack.h"
+#include "a2dtest.h"
+#include "a2dvec.h"
+#include "core/a2dsymmatveccore.h"
+#include "core/a2dveccore.h"
 
 namespace A2D {
 
@@ -12,34 +19,24 @@ A2D_FUNCTION void SymEigs2x2(const T* A, T* eigs, T* Q = nullptr) {
   T discrm = sqrt(diff * diff + 4.0 * A[1] * A[1]);
   T det = A[0] * A[2] - A[1] * A[1];
 
-  // Compute the eigenvalues such that eigs[0] <= eigs[1]
-  if (RealPart(tr) > 0.0) {
-    eigs[1] = 0.5 * (tr + discrm);
-    eigs[0] = det / eigs[1];
-  } else if (RealPart(tr) < 0.0) {
-    eigs[0] = 0.5 * (tr - discrm);
-    eigs[1] = det / eigs[0];
-  } else {
-    eigs[0] = -0.5 * discrm;
-    eigs[1] = 0.5 * discrm;
-  }
+  // Compute the eigenvalues such that eigs[0] <= eigs[1]. The root with the
+  // larger magnitude is computed directly and the other from the determinant.
+  // The branches are written as selects so that they are evaluated lane-wise.
+  auto pos = RealPart(tr) > 0.0;
+  auto neg = RealPart(tr) < 0.0;
+  T large = 0.5 * (tr + select(pos, discrm, T(-discrm)));
+  T small = det / select(pos | neg, large, T(1.0));
+  eigs[0] = select(pos, small, select(neg, large, T(-0.5 * discrm)));
+  eigs[1] = select(pos, large, select(neg, small, T(0.5 * discrm)));
 
   if (Q != nullptr) {
     // Compute the eigenvector components
-    T u = 1.0, v = 0.0;
-    if (RealPart(A[1]) != 0.0) {
-      if (RealPart(diff) > 0.0) {
-        T a = 0.5 * (diff + discrm);
-        T inv = 1.0 / sqrt(a * a + A[1] * A[1]);
-        u = inv * A[1];
-        v = -inv * a;
-      } else {
-        T a = 0.5 * (diff - discrm);
-        T inv = 1.0 / sqrt(a * a + A[1] * A[1]);
-        u = inv * a;
-        v = inv * A[1];
-      }
-    }
+    auto offdiag = RealPart(A[1]) != 0.0;
+    auto dpos = RealPart(diff) > 0.0;
+    T a = 0.5 * (diff + select(dpos, discrm, T(-discrm)));
+    T inv = 1.0 / sqrt(select(offdiag, T(a * a + A[1] * A[1]), T(1.0)));
+    T u = select(offdiag, T(inv * select(dpos, A[1], a)), T(1.0));
+    T v = select(offdiag, T(inv * select(dpos, T(-a), A[1])), T(0.0));
 
     // Set the eigenvector components
     Q[0] = u;
@@ -49,6 +46,135 @@ A2D_FUNCTION void SymEigs2x2(const T* A, T* eigs, T* Q = nullptr) {
   }
 }
 
+/**
+ * @brief Compute the eigenvalues and optionally eigenvectors of a 3x3
+ * symmetric matrix in closed form
+ *
+ * The eigenvalues of B = (A - q * I) / p, with q = tr(A) / 3, lie in [-2, 2]
+ * and are given by the trigonometric solution of the characteristic cubic.
+ * These lose accuracy near repeated roots, so they are only used to select
+ * the eigenvalue that is farthest from the other two. Its eigenvector is
+ * computed from the cross products of the rows of B - beta * I. The gap is at
+ * least half the spread of the eigenvalues of B, so this is well conditioned.
+ * The remaining pair is computed from the 2x2 projection of A onto the
+ * orthogonal complement with SymEigs2x2(), which handles the repeated and
+ * nearly repeated roots. The eigenvalues are returned such that eigs[0] <=
+ * eigs[1] <= eigs[2].
+ *
+ * @param A Packed symmetric matrix (6 entries)
+ * @param eigs Eigenvalues
+ * @param Q Eigenvectors stored column-wise in a row-major 3x3 matrix
+ */
+template <typename T>
+A2D_FUNCTION void SymEigs3x3(const T* A, T* eigs, T* Q = nullptr) {
+  // Compute the shift and scaling, p = 0 only when A = q * I
+  T q = (A[0] + A[2] + A[5]) / 3.0;
+  T b00 = A[0] - q, b11 = A[2] - q, b22 = A[5] - q;
+  T p2 = (b00 * b00 + b11 * b11 + b22 * b22 +
+          2.0 * (A[1] * A[1] + A[3] * A[3] + A[4] * A[4]));
+  auto iso = RealPart(p2) == 0.0;
+  T p = sqrt(select(iso, T(6.0), p2) / 6.0);
+  T pinv = 1.0 / p;
+
+  // B = (A - q * I) / p
+  b00 *= pinv;
+  b11 *= pinv;
+  b22 *= pinv;
+  T b01 = A[1] * pinv, b02 = A[3] * pinv, b12 = A[4] * pinv;
+
+  // r = det(B) / 2 in [-1, 1], up to round-off
+  T r = 0.5 * (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) +
+               b02 * (b01 * b12 - b11 * b02));
+  r = select(RealPart(r) > 1.0, T(1.0), r);
+  r = select(RealPart(r) < -1.0, T(-1.0), r);
+
+  // Eigenvalues of B in ascending order, 2 * cos(phi + 2 * pi * k / 3)
+  const double sqrt3 = 1.7320508075688772935;
+  T phi = acos(r) / 3.0;
+  T c = cos(phi), s = sin(phi);
+  T beta2 = 2.0 * c;
+  T beta0 = -c - sqrt3 * s;
+  T beta1 = -c + sqrt3 * s;
+
+  // Select the eigenvalue with the largest gap
+  auto low = RealPart(beta1 - beta0) >= RealPart(beta2 - beta1);
+  T beta = select(low, beta0, beta2);
+
+  // The eigenvector is the longest cross product of two rows of B - beta * I
+  T r0[3] = {b00 - beta, b01, b02};
+  T r1[3] = {b01, b11 - beta, b12};
+  T r2[3] = {b02, b12, b22 - beta};
+  T x01[3], x02[3], x12[3];
+  VecCrossCore<T>(r0, r1, x01);
+  VecCrossCore<T>(r0, r2, x02);
+  VecCrossCore<T>(r1, r2, x12);
+  T d01 = VecDotCore<T, 3>(x01, x01);
+  T d02 = VecDotCore<T, 3>(x02, x02);
+  T d12 = VecDotCore<T, 3>(x12, x12);
+
+  auto use02 = RealPart(d02) > RealPart(d01);
+  T dmax = select(use02, d02, d01);
+  auto use12 = RealPart(d12) > RealPart(dmax);
+  dmax = select(use12, d12, dmax);
+  T vinv = 1.0 / sqrt(dmax);
+  T v[3];
+  for (int i = 0; i < 3; i++) {
+    v[i] = vinv * select(use12, x12[i], select(use02, x02[i], x01[i]));
+  }
+
+  // Orthonormal basis u, w for the complement of v
+  auto first = absfunc(v[0]) > absfunc(v[1]);
+  T u[3] = {select(first, T(-v[2]), T(0.0)), select(first, T(0.0), v[2]),
+            select(first, v[0], T(-v[1]))};
+  T uinv = 1.0 / sqrt(VecDotCore<T, 3>(u, u));
+  for (int i = 0; i < 3; i++) {
+    u[i] *= uinv;
+  }
+  T w[3];
+  VecCrossCore<T>(v, u, w);
+
+  // Rayleigh quotient for v and the projection of A onto (u, w)
+  T Av[3], Au[3], Aw[3];
+  SymMatVecCore<T, 3>(A, v, Av);
+  SymMatVecCore<T, 3>(A, u, Au);
+  SymMatVecCore<T, 3>(A, w, Aw);
+  T lam = VecDotCore<T, 3>(v, Av);
+  T M[3] = {VecDotCore<T, 3>(u, Au), VecDotCore<T, 3>(u, Aw),
+            VecDotCore<T, 3>(w, Aw)};
+  T mu[2], Q2[4];
+  SymEigs2x2(M, mu, Q2);
+
+  // Place the isolated eigenvalue first or last. When the spread is at the
+  // level of round-off it may be out of order with the pair, so swap it.
+  auto swap01 = low & (RealPart(lam) > RealPart(mu[0]));
+  auto swap12 = !low & (RealPart(mu[1]) > RealPart(lam));
+  eigs[0] = select(low, lam, mu[0]);
+  eigs[1] = select(low, mu[0], mu[1]);
+  eigs[2] = select(low, mu[1], lam);
+  T e1 = eigs[1];
+  eigs[1] = select(swap01, eigs[0], select(swap12, eigs[2], e1));
+  eigs[0] = select(swap01, e1, eigs[0]);
+  eigs[2] = select(swap12, e1, eigs[2]);
+  if (Q == nullptr) {
+    return;
+  }
+
+  // The eigenvectors of the pair
+  T y0[3], y1[3];
+  for (int i = 0; i < 3; i++) {
+    y0[i] = Q2[0] * u[i] + Q2[2] * w[i];
+    y1[i] = Q2[1] * u[i] + Q2[3] * w[i];
+  }
+  for (int i = 0; i < 3; i++) {
+    T q0 = select(low, v[i], y0[i]);
+    T q1 = select(low, y0[i], y1[i]);
+    T q2 = select(low, y1[i], v[i]);
+    Q[3 * i] = select(swap01, q1, q0);
+    Q[3 * i + 1] = select(swap01, q0, select(swap12, q2, q1));
+    Q[3 * i + 2] = select(swap12, q1, q2);
+  }
+}
+
 /**
  * @brief Reduce a symmetric matrix to tridiagonal form
  *
@@ -79,9 +205,7 @@ A2D_FUNCTION void SymMatTriReduce(T* A, T* alpha, T* beta, T* w,
     sigma = sqrt(sigma);
 
     // Set sigma to reduce round-off error
-    if (RealPart(aj[j - 1]) < 0.0) {
-      sigma *= -1.0;
-    }
+    sigma = select(RealPart(aj[j - 1]) < 0.0, T(-sigma), sigma);
 
     // Comupte h = 1/2 *  u^{T} u
     T h = 0.0;
@@ -89,10 +213,8 @@ A2D_FUNCTION void SymMatTriReduce(T* A, T* alpha, T* beta, T* w,
       h += aj[i] * aj[i];
     }
     h += (aj[j - 1] + sigma) * (aj[j - 1] + sigma);
-    T hinv = 0.0;
-    if (RealPart(h) != 0.0) {
-      hinv = 2.0 / h;
-    }
+    auto nonzero = RealPart(h) != 0.0;
+    T hinv = select(nonzero, T(2.0 / select(nonzero, h, T(1.0))), T(0.0));
 
     // Compute the matrix-vector product w = hinv * A * u
     const T* ap = A;
@@ -188,87 +310,154 @@ A2D_FUNCTION void SymMatTriReduce(T* A, T* alpha, T* beta, T* w,
   }
 }
 
+/**
+ * @brief Counters for the QL iteration in TriSymEigs()
+ *
+ * The counters are accumulated over all calls that receive the same object,
+ * so they are not thread-safe. Use one object per thread and add them up.
+ */
+struct SymEigsStats {
+  int calls = 0;       // Number of calls
+  int iterations = 0;  // Total number of QL sweeps
+  int failures = 0;    // Eigenvalues not converged within max_iters
+
+  // Average number of QL sweeps per call
+  double average_iterations() const {
+    return calls > 0 ? static_cast<double>(iterations) / calls : 0.0;
+  }
+};
+
+/**
+ * @brief Convergence control for the general eigensolver (N >= 4)
+ *
+ * An off-diagonal entry beta[m] is treated as zero when it is negligible
+ * compared with |alpha[m]| + |alpha[m + 1]| in floating point, or when it is
+ * at most tol times this value. The default tol = 0 gives full precision.
+ */
+struct SymEigsOptions {
+  double tol = 0.0;               // Relative tolerance on the off-diagonals
+  int max_iters = 30;             // Maximum QL sweeps per eigenvalue
+  SymEigsStats* stats = nullptr;  // Optional counters
+};
+
 /**
  * @brief Compute the eigenvalues and optionally eigenvectors of a tridiagonal
  * matrix
  *
+ * For each eigenvalue, implicit QL sweeps are applied until the off-diagonal
+ * entry decouples it, or max_iters sweeps have been applied.
+ *
  * @tparam T Scalar type
  * @tparam N Dimension of the symmetric matrix
  * @param alpha Diagonal entries of length N (eigenvalue outputs)
  * @param beta Off-diagonal entries - length N (note this is not N-1)
  * @param Q Eigenvectors
+ * @param options The tolerance, iteration limit and optional counters
+ * @return true if all eigenvalues converged
  */
 template <typename T, int N>
-void TriSymEigs(T* alpha, T* beta, T* Q) {
+bool TriSymEigs(T* alpha, T* beta, T* Q,
+                const SymEigsOptions& options = SymEigsOptions()) {
+  int iterations = 0, failures = 0;
   for (int j = 0; j < N; j++) {
-    for (int iter = 0; iter < 30; iter++) {
+    int iter = 0;
+    bool converged = false;
+    for (;; iter++) {
       int m = j;
       for (; m < N - 1; m++) {
         double tr =
             (std::fabs(RealPart(alpha[m + 1])) + std::fabs(RealPart(alpha[m])));
-        if (tr + std::fabs(RealPart(beta[m])) == tr) {
+        double b = std::fabs(RealPart(beta[m]));
+        if (tr + b == tr || b <= options.tol * tr) {
           break;
         }
       }
 
-      //  m is the index we were looking for
-      if (m != j) {
-        // Compute whether the shift should be positive or negative
-        T g = (alpha[j + 1] - alpha[j]) / (2.0 * beta[j]);
-        T r = sqrt(1.0 + g * g);
-
-        // Compute the shift using the expression with less roundoff error
-        if (RealPart(g) >= 0.0) {
-          g = alpha[m] - alpha[j] + beta[j] / (g + r);
-        } else {
-          g = alpha[m] - alpha[j] + beta[j] / (g - r);
-        }
+      // The eigenvalue has converged, possibly after the last allowed sweep
+      if (m == j) {
+        converged = true;
+        break;
+      }
+      if (iter == options.max_iters) {
+        break;
+      }
 
-        // Apply the transformation
-        T c = 1.0, s = 1.0, p = 0.0;
-        int i = m - 1;
-        for (; i >= j; i--) {
-          T f = s * beta[i];
-          T b = c * beta[i];
-          r = sqrt(f * f + g * g);
-          beta[i + 1] = r;
-
-          if (RealPart(r) == 0.0) {
-            alpha[i + 1] -= p;
-            beta[m] = 0.0;
-            break;
-          }
+      // Compute whether the shift should be positive or negative
+      T g = (alpha[j + 1] - alpha[j]) / (2.0 * beta[j]);
+      T r = sqrt(1.0 + g * g);
 
-          s = f / r;
-          c = g / r;
-          g = alpha[i + 1] - p;
-          r = (alpha[i] - g) * s + 2.0 * c * b;
-          p = s * r;
-          alpha[i + 1] = g + p;
-          g = c * r - b;
-
-          if (Q) {
-            // Apply plane rotations to Q
-            for (int k = 0; k < N; k++) {
-              T q = Q[i + 1 + k * N];
-              Q[i + 1 + k * N] = s * Q[i + k * N] + c * q;
-              Q[i + k * N] = c * Q[i + k * N] - s * q;
-            }
-          }
+      // Compute the shift using the expression with less roundoff error
+      if (RealPart(g) >= 0.0) {
+        g = alpha[m] - alpha[j] + beta[j] / (g + r);
+      } else {
+        g = alpha[m] - alpha[j] + beta[j] / (g - r);
+      }
+
+      // Apply the transformation
+      T c = 1.0, s = 1.0, p = 0.0;
+      int i = m - 1;
+      for (; i >= j; i--) {
+        T f = s * beta[i];
+        T b = c * beta[i];
+        r = sqrt(f * f + g * g);
+        beta[i + 1] = r;
+
+        if (RealPart(r) == 0.0) {
+          alpha[i + 1] -= p;
+          beta[m] = 0.0;
+          break;
         }
-        if (RealPart(r) == 0.0 && i >= j) {
-          continue;
+
+        s = f / r;
+        c = g / r;
+        g = alpha[i + 1] - p;
+        r = (alpha[i] - g) * s + 2.0 * c * b;
+        p = s * r;
+        alpha[i + 1] = g + p;
+        g = c * r - b;
+
+        if (Q) {
+          // Apply plane rotations to Q
+          for (int k = 0; k < N; k++) {
+            T q = Q[i + 1 + k * N];
+            Q[i + 1 + k * N] = s * Q[i + k * N] + c * q;
+            Q[i + k * N] = c * Q[i + k * N] - s * q;
+          }
         }
-        alpha[j] -= p;
-        beta[j] = g;
-        beta[m] = 0.0;
       }
+      if (RealPart(r) == 0.0 && i >= j) {
+        continue;
+      }
+      alpha[j] -= p;
+      beta[j] = g;
+      beta[m] = 0.0;
+    }
+
+    iterations += iter;
+    if (!converged) {
+      failures++;
     }
   }
+
+  if (options.stats) {
+    options.stats->calls++;
+    options.stats->iterations += iterations;
+    options.stats->failures += failures;
+  }
+
+  return failures == 0;
 }
 
+/**
+ * @brief Compute the eigenvalues and optionally eigenvectors of a symmetric
+ * matrix by reduction to tridiagonal form and the QL iteration
+ *
+ * @return true if all eigenvalues converged
+ */
 template <typename T, int N>
-A2D_FUNCTION void SymEigsGeneral(const T* A, T* eigs, T* Q = nullptr) {
+A2D_FUNCTION bool SymEigsGeneral(
+    const T* A, T* eigs, T* Q = nullptr,
+    const SymEigsOptions& options = SymEigsOptions()) {
   T Acopy[N * (N + 1) / 2], work[2 * N];
   for (int i = 0; i < N * (N + 1) / 2; i++) {
     Acopy[i] = A[i];
@@ -284,7 +473,7 @@ A2D_FUNCTION void SymEigsGeneral(const T* A, T* eigs, T* Q = nullptr) {
     }
   }
   SymMatTriReduce<T, N>(Acopy, eigs, &work[0], &work[N], Q);
-  TriSymEigs<T, N>(eigs, &work[0], Q);
+  return TriSymEigs<T, N>(eigs, &work[0], Q, options);
 }
 
 template <typename T, int N>
@@ -397,13 +586,18 @@ A2D_FUNCTION void SymEigsHReverse(const T* eigs, const T* Q, const T* beigs,
 
 /**
  * Compute the eigenvalues and eigenvectors of a symmetric eigenvalue problem
+ *
+ * The options only apply to the iterative solver used for N >= 4.
  */
 template <typename T, int N>
-A2D_FUNCTION void SymEigs(const SymMat<T, N>& S, Vec<T, N>& eigs) {
+A2D_FUNCTION void SymEigs(const SymMat<T, N>& S, Vec<T, N>& eigs,
+                          const SymEigsOptions& options = SymEigsOptions()) {
   if constexpr (N == 2) {
     SymEigs2x2(get_data(S), get_data(eigs));
+  } else if constexpr (N == 3) {
+    SymEigs3x3(get_data(S), get_data(eigs));
   } else {
-    SymEigsGeneral<T, N>(get_data(S), get_data(eigs));
+    SymEigsGeneral<T, N>(get_data(S), get_data(eigs), nullptr, options);
   }
 }
 
@@ -420,13 +614,18 @@ class SymEigsExpr {
   static constexpr int K = get_vec_size<etype>::size;
   static_assert(K == N, "Vector of eigenvalues must be correct size");
 
-  A2D_FUNCTION SymEigsExpr(Stype& S, etype& eigs) : S(S), eigs(eigs) {}
+  A2D_FUNCTION SymEigsExpr(Stype& S, etype& eigs,
+                           const SymEigsOptions& options = SymEigsOptions())
+      : S(S), eigs(eigs), options(options), Q(uninit) {}
 
   A2D_FUNCTION void eval() {
     if constexpr (N == 2) {
       SymEigs2x2(get_data(S), get_data(eigs), get_data(Q));
+    } else if constexpr (N == 3) {
+      SymEigs3x3(get_data(S), get_data(eigs), get_data(Q));
     } else {
-      SymEigsGeneral<T, N>(get_data(S), get_data(eigs), get_data(Q));
+      SymEigsGeneral<T, N>(get_data(S), get_data(eigs), get_data(Q),
+                           options);
     }
   }
 
@@ -462,17 +661,20 @@ class SymEigsExpr {
  private:
   Stype& S;
   etype& eigs;
+  SymEigsOptions options;
   Mat<T, N, N> Q;
 };
 
 template <class Stype, class etype>
-A2D_FUNCTION auto SymEigs(ADObj<Stype>& S, ADObj<etype>& eigs) {
-  return SymEigsExpr<ADObj<Stype>, ADObj<etype>>(S, eigs);
+A2D_FUNCTION auto SymEigs(ADObj<Stype>& S, ADObj<etype>& eigs,
+                          const SymEigsOptions& options = SymEigsOptions()) {
+  return SymEigsExpr<ADObj<Stype>, ADObj<etype>>(S, eigs, options);
 }
 
 template <class Stype, class etype>
-A2D_FUNCTION auto SymEigs(A2DObj<Stype>& S, A2DObj<etype>& eigs) {
-  return SymEigsExpr<A2DObj<Stype>, A2DObj<etype>>(S, eigs);
+A2D_FUNCTION auto SymEigs(A2DObj<Stype>& S, A2DObj<etype>& eigs,
+                          const SymEigsOptions& options = SymEigsOptions()) {
+  return SymEigsExpr<A2DObj<Stype>, A2DObj<etype>>(S, eigs, options);
 }
 
 namespace Test {
@@ -11,12 +11,14 @@ class Vec {
   typedef T type;
   static const ADObjType obj_type = ADObjType::VECTOR;
   static const index_t ncomp = N;
+  static constexpr std::size_t align = storage_alignment<T>::value;
 
   A2D_FUNCTION Vec() {
     for (int i = 0; i < N; i++) {
       V[i] = 0.0;
     }
   }
+  A2D_FUNCTION Vec(uninit_t) {}
   template <typename T2>
   A2D_FUNCTION Vec(const T2* vals) {
     for (int i = 0; i < N; i++) {
@@ -49,8 +51,8 @@ class Vec {
     return V[i];
   }
 
-  A2D_FUNCTION T* get_data() { return V; }
-  A2D_FUNCTION const T* get_data() const { return V; }
+  A2D_FUNCTION T* get_data() { return assume_aligned<align>(V); }
+  A2D_FUNCTION const T* get_data() const { return assume_aligned<align>(V); }
 
   template <typename I>
   A2D_FUNCTION T& operator[](const I i) {
@@ -62,7 +64,7 @@ class Vec {
   }
 
  private:
-  T V[N];
+  alignas(align) T V[N];
 };
 
 template <typename T>
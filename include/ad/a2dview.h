@@ -0,0 +1,228 @@
+#ifndef A2D_VIEW_H
+#define A2D_VIEW_H
+
+#include "../a2ddefs.h"
+#include "a2dmat.h"
+#include "a2dvec.h"
+
+namespace A2D {
+
+/*
+  Non-owning views of Mat, SymMat and Vec data stored in external arrays.
+
+  A view wraps a pointer to contiguous entries with the same layout as the
+  owning object (row-major for MatView, packed lower triangle for SymMatView),
+  so views can be used wherever a Mat, SymMat or Vec is expected, including
+  ADObj<MatView<...>> and A2DObj<MatView<...>> with the seeds pointing into
+  global adjoint or Hessian-vector arrays.
+
+  Like a reference, copy construction aliases the same data while assignment
+  copies the entries. Use rebind() to point an existing view at new data.
+*/
+template <typename T, int M, int N>
+class MatView {
+ public:
+  typedef T type;
+  static const ADObjType obj_type = ADObjType::MATRIX;
+  static const index_t ncomp = M * N;
+  static const int nrows = M;
+  static const int ncols = N;
+
+  A2D_FUNCTION MatView() : A(nullptr) {}
+  A2D_FUNCTION MatView(T* data) : A(data) {}
+  A2D_FUNCTION MatView(Mat<T, M, N>& mat) : A(mat.get_data()) {}
+  A2D_FUNCTION MatView(const MatView<T, M, N>& src) : A(src.A) {}
+
+  A2D_FUNCTION MatView<T, M, N>& operator=(const MatView<T, M, N>& src) {
+    copy(src);
+    return *this;
+  }
+
+  A2D_FUNCTION void rebind(T* data) { A = data; }
+
+  A2D_FUNCTION void zero() {
+    for (int i = 0; i < M * N; i++) {
+      A[i] = 0.0;
+    }
+  }
+  template <class Src>
+  A2D_FUNCTION void copy(const Src& src) {
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        A[N * i + j] = src(i, j);
+      }
+    }
+  }
+  template <class IdxType1, class IdxType2>
+  A2D_FUNCTION T& operator()(const IdxType1 i, const IdxType2 j) {
+    return A[N * i + j];
+  }
+  template <class IdxType1, class IdxType2>
+  A2D_FUNCTION const T& operator()(const IdxType1 i, const IdxType2 j) const {
+    return A[N * i + j];
+  }
+
+  A2D_FUNCTION T* get_data() { return A; }
+  A2D_FUNCTION const T* get_data() const { return A; }
+
+  template <typename I>
+  A2D_FUNCTION T& operator[](const I i) {
+    return A[i];
+  }
+  template <typename I>
+  A2D_FUNCTION const T& operator[](const I i) const {
+    return A[i];
+  }
+
+ private:
+  T* A;
+};
+
+template <typename T, int N>
+class SymMatView {
+ public:
+  typedef T type;
+  static const ADObjType obj_type = ADObjType::SYMMAT;
+  static const int MAT_SIZE = (N * (N + 1)) / 2;
+  static const index_t ncomp = MAT_SIZE;
+  static constexpr int nrows = N;
+  static constexpr int ncols = N;
+
+  A2D_FUNCTION SymMatView() : A(nullptr) {}
+  A2D_FUNCTION SymMatView(T* data) : A(data) {}
+  A2D_FUNCTION SymMatView(SymMat<T, N>& mat) : A(mat.get_data()) {}
+  A2D_FUNCTION SymMatView(const SymMatView<T, N>& src) : A(src.A) {}
+
+  A2D_FUNCTION SymMatView<T, N>& operator=(const SymMatView<T, N>& src) {
+    copy(src);
+    return *this;
+  }
+
+  A2D_FUNCTION void rebind(T* data) { A = data; }
+
+  A2D_FUNCTION void zero() {
+    for (int i = 0; i < MAT_SIZE; i++) {
+      A[i] = 0.0;
+    }
+  }
+  template <class Src>
+  A2D_FUNCTION void copy(const Src& src) {
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j <= i; j++) {
+        A[j + i * (i + 1) / 2] = src(i, j);
+      }
+    }
+  }
+
+  template <class IdxType1, class IdxType2>
+  A2D_FUNCTION T& operator()(const IdxType1 i, const IdxType2 j) {
+    if (i >= j) {
+      return A[j + i * (i + 1) / 2];
+    } else {
+      return A[i + j * (j + 1) / 2];
+    }
+  }
+  template <class IdxType1, class IdxType2>
+  A2D_FUNCTION const T& operator()(const IdxType1 i, const IdxType2 j) const {
+    if (i >= j) {
+      return A[j + i * (i + 1) / 2];
+    } else {
+      return A[i + j * (j + 1) / 2];
+    }
+  }
+
+  A2D_FUNCTION T* get_data() { return A; }
+  A2D_FUNCTION const T* get_data() const { return A; }
+
+  template <typename I>
+  A2D_FUNCTION T& operator[](const I i) {
+    return A[i];
+  }
+  template <typename I>
+  A2D_FUNCTION const T& operator[](const I i) const {
+    return A[i];
+  }
+
+ private:
+  T* A;
+};
+
+template <typename T, int N>
+class VecView {
+ public:
+  typedef T type;
+  static const ADObjType obj_type = ADObjType::VECTOR;
+  static const index_t ncomp = N;
+
+  A2D_FUNCTION VecView() : V(nullptr) {}
+  A2D_FUNCTION VecView(T* data) : V(data) {}
+  A2D_FUNCTION VecView(Vec<T, N>& vec) : V(vec.get_data()) {}
+  A2D_FUNCTION VecView(const VecView<T, N>& src) : V(src.V) {}
+
+  A2D_FUNCTION VecView<T, N>& operator=(const VecView<T, N>& src) {
+    copy(src);
+    return *this;
+  }
+
+  A2D_FUNCTION void rebind(T* data) { V = data; }
+
+  A2D_FUNCTION void zero() {
+    for (int i = 0; i < N; i++) {
+      V[i] = 0.0;
+    }
+  }
+  template <class Src>
+  A2D_FUNCTION void copy(const Src& src) {
+    for (int i = 0; i < N; i++) {
+      V[i] = src(i);
+    }
+  }
+  template <class IdxType>
+  A2D_FUNCTION T& operator()(const IdxType i) {
+    return V[i];
+  }
+  template <class IdxType>
+  A2D_FUNCTION const T& operator()(const IdxType i) const {
+    return V[i];
+  }
+
+  A2D_FUNCTION T* get_data() { return V; }
+  A2D_FUNCTION const T* get_data() const { return V; }
+
+  template <typename I>
+  A2D_FUNCTION T& operator[](const I i) {
+    return V[i];
+  }
+  template <typename I>
+  A2D_FUNCTION const T& operator[](const I i) const {
+    return V[i];
+  }
+
+ private:
+  T* V;
+};
+
+template <typename T>
+struct is_a2d_view : std::false_type {};
+
+template <typename T, int M, int N>
+struct is_a2d_view<MatView<T, M, N>> : std::true_type {};
+
+template <typename T, int N>
+struct is_a2d_view<SymMatView<T, N>> : std::true_type {};
+
+template <typename T, int N>
+struct is_a2d_view<VecView<T, N>> : std::true_type {};
+
+template <typename U, int M, int N>
+struct is_a2d_matrix<MatView<U, M, N>> : std::true_type {};
+
+template <typename U, int N>
+struct is_a2d_sym_matrix<SymMatView<U, N>> : std::true_type {};
+
+template <typename U, int N>
+struct is_a2d_vector<VecView<U, N>> : std::true_type {};
+
+}  // namespace A2D
+
+#endif  // A2D_VIEW_H
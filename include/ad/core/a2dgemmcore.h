@@ -436,6 +436,154 @@ A2D_FUNCTION void MatMatMultScaleCoreGeneral(const T alpha, const T A[],
   }
 }
 
+/**
+ * @brief Register-blocked micro-kernel: compute the MR-by-NR block of C with
+ * the upper left corner (i0, j0), C = alpha * Op(A) * Op(B)
+ *
+ * The block of C is accumulated in registers while the inner dimension is
+ * swept with rank-1 updates. All strides are compile-time constants, so the
+ * index arithmetic for the transpose cases is resolved at compile time and
+ * the loops are fully unrolled. For the unscaled additive case the block is
+ * initialized from C so that the write-back is a plain store.
+ *
+ * @tparam T: scalar type
+ * @tparam MR: number of rows in the block
+ * @tparam NR: number of columns in the block
+ * @tparam M: number of rows of C
+ * @tparam N: number of columns of C
+ * @tparam P: inner dimension
+ * @tparam opA: transpose A or not
+ * @tparam opB: transpose B or not
+ * @tparam additive: true for increment (C += ..), false for assignment (C = ..)
+ * @tparam scale: true if the result is scaled by alpha
+ */
+template <typename T, int MR, int NR, int M, int N, int P, MatOp opA,
+          MatOp opB, bool additive, bool scale>
+A2D_FUNCTION void MatMatMultMicroKernel(const int i0, const int j0,
+                                        const T alpha, const T A[],
+                                        const T B[], T C[]) {
+  T c[MR][NR];
+  for (int r = 0; r < MR; r++) {
+    const T* Cr = &C[N * (i0 + r) + j0];
+    for (int s = 0; s < NR; s++) {
+      if constexpr (additive and !scale) {
+        c[r][s] = Cr[s];
+      } else {
+        c[r][s] = T(0.0);
+      }
+    }
+  }
+
+  for (int k = 0; k < P; k++) {
+    T a[MR], b[NR];
+    for (int r = 0; r < MR; r++) {
+      if constexpr (opA == MatOp::NORMAL) {
+        a[r] = A[P * (i0 + r) + k];  // A is M-by-P
+      } else {
+        a[r] = A[M * k + i0 + r];  // A is P-by-M
+      }
+    }
+    for (int s = 0; s < NR; s++) {
+      if constexpr (opB == MatOp::NORMAL) {
+        b[s] = B[N * k + j0 + s];  // B is P-by-N
+      } else {
+        b[s] = B[P * (j0 + s) + k];  // B is N-by-P
+      }
+    }
+
+    for (int r = 0; r < MR; r++) {
+      for (int s = 0; s < NR; s++) {
+        c[r][s] += a[r] * b[s];
+      }
+    }
+  }
+
+  for (int r = 0; r < MR; r++) {
+    T* Cr = &C[N * (i0 + r) + j0];
+    for (int s = 0; s < NR; s++) {
+      if constexpr (scale) {
+        c[r][s] = alpha * c[r][s];
+      }
+      if constexpr (additive and scale) {
+        Cr[s] += c[r][s];
+      } else {
+        Cr[s] = c[r][s];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Whether MatMatMultCore uses the register-blocked kernel for C =
+ * Op(A) * Op(B) with C of size M x N and inner dimension P
+ *
+ * The choice follows examples/benchmarks/bench_gemm at -O3. When Op(B) = B,
+ * the naive loops read the rows of B contiguously and the compiler vectorizes
+ * them well, so the tiling only pays off for long inner dimensions. When
+ * Op(B) = B^T, the tiling pays off from about 1000 multiply-adds, and from
+ * 6 x 6 x 6 when A is also transposed, except when N is a multiple of 8 (for
+ * instance 8 x 8 x 8), where the naive loops stay faster.
+ */
+template <int M, int N, int P, MatOp opA, MatOp opB>
+constexpr bool MatMatMultUseBlocked() {
+  if constexpr (opB == MatOp::NORMAL) {
+    return P >= 24 && M * N * P >= 512;
+  } else if constexpr (opA == MatOp::TRANSPOSE) {
+    return M * N * P >= 1000 || (M * N * P >= 216 && N % 8 != 0);
+  } else {
+    return M * N * P >= 1000;
+  }
+}
+
+/**
+ * @brief Register-blocked mat-mat multiplication C = alpha * Op(A) * Op(B)
+ *
+ * C is split into MR-by-NR tiles that are computed by the micro-kernel, the
+ * remainder rows and columns are handled by micro-kernels with smaller
+ * compile-time tile sizes.
+ *
+ * @tparam T: scalar type
+ * @tparam M: number of rows of C
+ * @tparam N: number of columns of C
+ * @tparam P: inner dimension
+ * @tparam opA: transpose A or not
+ * @tparam opB: transpose B or not
+ * @tparam additive: true for increment (C += ..), false for assignment (C = ..)
+ * @tparam scale: true if the result is scaled by alpha
+ */
+template <typename T, int M, int N, int P, MatOp opA = MatOp::NORMAL,
+          MatOp opB = MatOp::NORMAL, bool additive = false, bool scale = false>
+A2D_FUNCTION void MatMatMultCoreBlocked(const T alpha, const T A[],
+                                        const T B[], T C[]) {
+  // Tile sizes: 4 x 4 accumulators fit in the register file for both scalar
+  // and lane-packed numeric types
+  constexpr int MR = (M < 4 ? M : 4);
+  constexpr int NR = (N < 4 ? N : 4);
+  constexpr int Mfull = M - M % MR;
+  constexpr int Nfull = N - N % NR;
+
+  for (int i0 = 0; i0 < Mfull; i0 += MR) {
+    for (int j0 = 0; j0 < Nfull; j0 += NR) {
+      MatMatMultMicroKernel<T, MR, NR, M, N, P, opA, opB, additive, scale>(
+          i0, j0, alpha, A, B, C);
+    }
+    if constexpr (N % NR != 0) {
+      MatMatMultMicroKernel<T, MR, N % NR, M, N, P, opA, opB, additive, scale>(
+          i0, Nfull, alpha, A, B, C);
+    }
+  }
+  if constexpr (M % MR != 0) {
+    for (int j0 = 0; j0 < Nfull; j0 += NR) {
+      MatMatMultMicroKernel<T, M % MR, NR, M, N, P, opA, opB, additive, scale>(
+          Mfull, j0, alpha, A, B, C);
+    }
+    if constexpr (N % NR != 0) {
+      MatMatMultMicroKernel<T, M % MR, N % NR, M, N, P, opA, opB, additive,
+                            scale>(Mfull, Nfull, alpha, A, B, C);
+    }
+  }
+}
+
 /**
  * @brief matrix-matrix multiplication C = alpha * Op(A) * Op(B), where op
  * is normal (nominal) or transpose
@@ -488,9 +636,17 @@ A2D_FUNCTION void MatMatMultCore(const T A[], const T B[], T C[]) {
     } else {
       MatMatMultCore3x3<T, opA, opB>(A, B, C);
     }
-  } else {  // The general fallback implmentation
-    MatMatMultCoreGeneral<T, Anrows, Ancols, Bnrows, Bncols, Cnrows, Cncols,
-                          opA, opB, additive>(A, B, C);
+  } else {
+    constexpr int P =
+        int_conditional<opA == MatOp::NORMAL, Ancols, Anrows>::value;
+    if constexpr (MatMatMultUseBlocked<Cnrows, Cncols, P, opA, opB>()) {
+      // The general register-blocked implementation
+      MatMatMultCoreBlocked<T, Cnrows, Cncols, P, opA, opB, additive, false>(
+          T(1.0), A, B, C);
+    } else {  // The general fallback implmentation
+      MatMatMultCoreGeneral<T, Anrows, Ancols, Bnrows, Bncols, Cnrows, Cncols,
+                            opA, opB, additive>(A, B, C);
+    }
   }
 }
 
@@ -519,9 +675,17 @@ inline void MatMatMultScaleCore(T alpha, const T A[], const T B[], T C[]) {
     } else {
       MatMatMultCore3x3Scale<T, opA, opB>(alpha, A, B, C);
     }
-  } else {  // The general fallback implmentation
-    MatMatMultScaleCoreGeneral<T, Anrows, Ancols, Bnrows, Bncols, Cnrows,
-                               Cncols, opA, opB, additive>(alpha, A, B, C);
+  } else {
+    constexpr int P =
+        int_conditional<opA == MatOp::NORMAL, Ancols, Anrows>::value;
+    if constexpr (MatMatMultUseBlocked<Cnrows, Cncols, P, opA, opB>()) {
+      // The general register-blocked implementation
+      MatMatMultCoreBlocked<T, Cnrows, Cncols, P, opA, opB, additive, true>(
+          alpha, A, B, C);
+    } else {  // The general fallback implmentation
+      MatMatMultScaleCoreGeneral<T, Anrows, Ancols, Bnrows, Bncols, Cnrows,
+                                 Cncols, opA, opB, additive>(alpha, A, B, C);
+    }
   }
 }
 
@@ -0,0 +1,338 @@
+#ifndef A2D_GEMM_CORE_BATCH_H
+#define A2D_GEMM_CORE_BATCH_H
+
+#include <type_traits>
+
+#include "../../a2ddefs.h"
+#include "a2dgemmcore.h"
+
+// The explicitly vectorized kernels are only available for x86-64 host code
+// compiled with GCC or clang, everything else uses the scalar kernels
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(__CUDACC__)
+#define A2D_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace A2D {
+
+/**
+ * @brief Instruction sets used by the batched kernels, in increasing order.
+ * AVX2 also requires FMA.
+ */
+enum class SimdISA { SCALAR, AVX2, AVX512 };
+
+/**
+ * @brief Get the widest instruction set supported by the CPU at run time
+ *
+ * The CPU is queried once and the result is cached.
+ */
+inline SimdISA GetSimdISA() {
+#ifdef A2D_X86_DISPATCH
+  static const SimdISA isa = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return SimdISA::AVX512;
+    } else if (__builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma")) {
+      return SimdISA::AVX2;
+    }
+    return SimdISA::SCALAR;
+  }();
+  return isa;
+#else
+  return SimdISA::SCALAR;
+#endif
+}
+
+/*
+  Offsets of the k-th term of entry (i, j) of C = Op(A) * Op(B) for 3x3
+  matrices stored row-major
+*/
+template <MatOp op>
+constexpr int Mat3x3LeftIndex(int i, int k) {
+  return op == MatOp::NORMAL ? 3 * i + k : 3 * k + i;
+}
+
+template <MatOp op>
+constexpr int Mat3x3RightIndex(int k, int j) {
+  return op == MatOp::NORMAL ? 3 * k + j : 3 * j + k;
+}
+
+/**
+ * @brief Scalar kernel for a batch of 3x3 products, used as the fallback and
+ * for the remainder of the vectorized kernels
+ */
+template <typename T, MatOp opA, MatOp opB, bool additive, bool scale>
+inline void MatMatMultCore3x3BatchScalar(const index_t n, const T alpha,
+                                         const T A[], const T B[], T C[]) {
+  for (index_t i = 0; i < n; i++, A += 9, B += 9, C += 9) {
+    if constexpr (additive and scale) {
+      MatMatMultCore3x3ScaleAdd<T, opA, opB>(alpha, A, B, C);
+    } else if constexpr (additive) {
+      MatMatMultCore3x3Add<T, opA, opB>(A, B, C);
+    } else if constexpr (scale) {
+      MatMatMultCore3x3Scale<T, opA, opB>(alpha, A, B, C);
+    } else {
+      MatMatMultCore3x3<T, opA, opB>(A, B, C);
+    }
+  }
+}
+
+#ifdef A2D_X86_DISPATCH
+
+/*
+  Transpose the 4x4 block of doubles stored in the rows r0, ..., r3
+*/
+__attribute__((target("avx2,fma"), always_inline)) inline void Transpose4x4AVX2(
+    __m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3) {
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+  r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+  r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+  r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+  r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+/*
+  Load 4 consecutive 3x3 matrices so that x[e] holds entry e of each matrix
+*/
+__attribute__((target("avx2,fma"), always_inline)) inline void Load3x3x4AVX2(
+    const double A[], __m256d x[]) {
+  for (int w = 0; w < 4; w++) {
+    x[w] = _mm256_loadu_pd(&A[9 * w]);
+    x[4 + w] = _mm256_loadu_pd(&A[9 * w + 4]);
+  }
+  Transpose4x4AVX2(x[0], x[1], x[2], x[3]);
+  Transpose4x4AVX2(x[4], x[5], x[6], x[7]);
+  x[8] = _mm256_setr_pd(A[8], A[17], A[26], A[35]);
+}
+
+/**
+ * @brief Compute 4 consecutive 3x3 products with AVX2, one matrix per lane
+ *
+ * The terms are summed in the same order as in the scalar kernels, but with
+ * fused multiply-adds, so the results may differ in the last bits.
+ */
+template <MatOp opA, MatOp opB, bool additive, bool scale>
+__attribute__((target("avx2,fma"))) void MatMatMultCore3x3x4AVX2(
+    const double alpha, const double A[], const double B[], double C[]) {
+  __m256d a[9], b[9], c[9];
+  Load3x3x4AVX2(A, a);
+  Load3x3x4AVX2(B, b);
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      __m256d s = _mm256_mul_pd(a[Mat3x3LeftIndex<opA>(i, 0)],
+                                b[Mat3x3RightIndex<opB>(0, j)]);
+      for (int k = 1; k < 3; k++) {
+        s = _mm256_fmadd_pd(a[Mat3x3LeftIndex<opA>(i, k)],
+                            b[Mat3x3RightIndex<opB>(k, j)], s);
+      }
+      if constexpr (scale) {
+        s = _mm256_mul_pd(_mm256_set1_pd(alpha), s);
+      }
+      c[3 * i + j] = s;
+    }
+  }
+
+  // Transpose back so that c[w] and c[4 + w] hold the entries of matrix w
+  Transpose4x4AVX2(c[0], c[1], c[2], c[3]);
+  Transpose4x4AVX2(c[4], c[5], c[6], c[7]);
+  double c8[4];
+  _mm256_storeu_pd(c8, c[8]);
+  for (int w = 0; w < 4; w++) {
+    if constexpr (additive) {
+      c[w] = _mm256_add_pd(_mm256_loadu_pd(&C[9 * w]), c[w]);
+      c[4 + w] = _mm256_add_pd(_mm256_loadu_pd(&C[9 * w + 4]), c[4 + w]);
+      C[9 * w + 8] += c8[w];
+    } else {
+      C[9 * w + 8] = c8[w];
+    }
+    _mm256_storeu_pd(&C[9 * w], c[w]);
+    _mm256_storeu_pd(&C[9 * w + 4], c[4 + w]);
+  }
+}
+
+// GCC 12 reports the _mm512_undefined_pd() used inside the AVX-512 shuffle
+// intrinsics as uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+/*
+  Transpose the 8x8 block of doubles stored in the rows r[0], ..., r[7]
+*/
+__attribute__((target("avx512f"), always_inline)) inline void
+Transpose8x8AVX512(__m512d r[]) {
+  __m512d t[8], u[8];
+  for (int i = 0; i < 4; i++) {
+    t[2 * i] = _mm512_unpacklo_pd(r[2 * i], r[2 * i + 1]);
+    t[2 * i + 1] = _mm512_unpackhi_pd(r[2 * i], r[2 * i + 1]);
+  }
+  for (int i = 0; i < 2; i++) {
+    u[4 * i] = _mm512_shuffle_f64x2(t[4 * i], t[4 * i + 2], 0x88);
+    u[4 * i + 1] = _mm512_shuffle_f64x2(t[4 * i + 1], t[4 * i + 3], 0x88);
+    u[4 * i + 2] = _mm512_shuffle_f64x2(t[4 * i], t[4 * i + 2], 0xdd);
+    u[4 * i + 3] = _mm512_shuffle_f64x2(t[4 * i + 1], t[4 * i + 3], 0xdd);
+  }
+  for (int i = 0; i < 4; i++) {
+    r[i] = _mm512_shuffle_f64x2(u[i], u[4 + i], 0x88);
+    r[4 + i] = _mm512_shuffle_f64x2(u[i], u[4 + i], 0xdd);
+  }
+}
+
+/*
+  Load 8 consecutive 3x3 matrices so that x[e] holds entry e of each matrix
+*/
+__attribute__((target("avx512f"), always_inline)) inline void
+Load3x3x8AVX512(const double A[], __m512d x[]) {
+  for (int w = 0; w < 8; w++) {
+    x[w] = _mm512_loadu_pd(&A[9 * w]);
+  }
+  Transpose8x8AVX512(x);
+  x[8] = _mm512_setr_pd(A[8], A[17], A[26], A[35], A[44], A[53], A[62],
+                        A[71]);
+}
+
+/**
+ * @brief Compute 8 consecutive 3x3 products with AVX-512, one matrix per
+ * lane
+ *
+ * As for AVX2, the terms are summed with fused multiply-adds.
+ */
+template <MatOp opA, MatOp opB, bool additive, bool scale>
+__attribute__((target("avx512f"))) void MatMatMultCore3x3x8AVX512(
+    const double alpha, const double A[], const double B[], double C[]) {
+  __m512d a[9], b[9], c[9];
+  Load3x3x8AVX512(A, a);
+  Load3x3x8AVX512(B, b);
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      __m512d s = _mm512_mul_pd(a[Mat3x3LeftIndex<opA>(i, 0)],
+                                b[Mat3x3RightIndex<opB>(0, j)]);
+      for (int k = 1; k < 3; k++) {
+        s = _mm512_fmadd_pd(a[Mat3x3LeftIndex<opA>(i, k)],
+                            b[Mat3x3RightIndex<opB>(k, j)], s);
+      }
+      if constexpr (scale) {
+        s = _mm512_mul_pd(_mm512_set1_pd(alpha), s);
+      }
+      c[3 * i + j] = s;
+    }
+  }
+
+  // Transpose back so that c[w] holds the first 8 entries of matrix w
+  Transpose8x8AVX512(c);
+  double c8[8];
+  _mm512_storeu_pd(c8, c[8]);
+  for (int w = 0; w < 8; w++) {
+    if constexpr (additive) {
+      c[w] = _mm512_add_pd(_mm512_loadu_pd(&C[9 * w]), c[w]);
+      C[9 * w + 8] += c8[w];
+    } else {
+      C[9 * w + 8] = c8[w];
+    }
+    _mm512_storeu_pd(&C[9 * w], c[w]);
+  }
+}
+
+#pragma GCC diagnostic pop
+
+#endif  // A2D_X86_DISPATCH
+
+/**
+ * @brief Compute a batch of 3x3 products using the given instruction set
+ *
+ * Full blocks of 8 (AVX-512) or 4 (AVX2) matrices are computed with the
+ * vectorized kernels and the remainder with the scalar kernel. If the
+ * instruction set is not available on the CPU, the behavior is undefined, use
+ * GetSimdISA() to select it.
+ *
+ * @param isa The instruction set
+ * @param n The number of matrices
+ * @param alpha The scalar multiplier (ignored when scale is false)
+ * @param A Array of n 3x3 row-major matrices
+ * @param B Array of n 3x3 row-major matrices
+ * @param C Array of n 3x3 row-major matrices
+ */
+template <MatOp opA, MatOp opB, bool additive, bool scale>
+inline void MatMatMultCore3x3BatchISA(const SimdISA isa, const index_t n,
+                                      const double alpha, const double A[],
+                                      const double B[], double C[]) {
+  index_t i = 0;
+#ifdef A2D_X86_DISPATCH
+  if (isa == SimdISA::AVX512) {
+    for (; i + 8 <= n; i += 8) {
+      MatMatMultCore3x3x8AVX512<opA, opB, additive, scale>(
+          alpha, &A[9 * i], &B[9 * i], &C[9 * i]);
+    }
+  }
+  if (isa == SimdISA::AVX2 || isa == SimdISA::AVX512) {
+    for (; i + 4 <= n; i += 4) {
+      MatMatMultCore3x3x4AVX2<opA, opB, additive, scale>(
+          alpha, &A[9 * i], &B[9 * i], &C[9 * i]);
+    }
+  }
+#endif  // A2D_X86_DISPATCH
+  MatMatMultCore3x3BatchScalar<double, opA, opB, additive, scale>(
+      n - i, alpha, &A[9 * i], &B[9 * i], &C[9 * i]);
+}
+
+template <typename T, MatOp opA, MatOp opB, bool additive, bool scale>
+inline void MatMatMultCore3x3BatchDispatch(const index_t n, const T alpha,
+                                           const T A[], const T B[], T C[]) {
+  if constexpr (std::is_same<T, double>::value) {
+    MatMatMultCore3x3BatchISA<opA, opB, additive, scale>(GetSimdISA(), n,
+                                                         alpha, A, B, C);
+  } else {
+    MatMatMultCore3x3BatchScalar<T, opA, opB, additive, scale>(n, alpha, A, B,
+                                                               C);
+  }
+}
+
+/**
+ * @brief Batched versions of MatMatMultCore3x3, MatMatMultCore3x3Add,
+ * MatMatMultCore3x3Scale and MatMatMultCore3x3ScaleAdd
+ *
+ * Each array holds n consecutive 3x3 row-major matrices. For double, the
+ * kernel is selected at run time based on the CPU (AVX-512, AVX2 or scalar),
+ * all other numeric types use the scalar kernels.
+ *
+ * @param n The number of matrices
+ * @param scalar The scalar multiplier (Scale variants)
+ * @param A Array of n 3x3 matrices
+ * @param B Array of n 3x3 matrices
+ * @param C Array of n 3x3 matrices
+ */
+template <typename T, MatOp opA = MatOp::NORMAL, MatOp opB = MatOp::NORMAL>
+inline void MatMatMultCore3x3Batch(const index_t n, const T A[], const T B[],
+                                   T C[]) {
+  MatMatMultCore3x3BatchDispatch<T, opA, opB, false, false>(n, T(1.0), A, B,
+                                                            C);
+}
+
+template <typename T, MatOp opA = MatOp::NORMAL, MatOp opB = MatOp::NORMAL>
+inline void MatMatMultCore3x3AddBatch(const index_t n, const T A[],
+                                      const T B[], T C[]) {
+  MatMatMultCore3x3BatchDispatch<T, opA, opB, true, false>(n, T(1.0), A, B, C);
+}
+
+template <typename T, MatOp opA = MatOp::NORMAL, MatOp opB = MatOp::NORMAL>
+inline void MatMatMultCore3x3ScaleBatch(const index_t n, const T scalar,
+                                        const T A[], const T B[], T C[]) {
+  MatMatMultCore3x3BatchDispatch<T, opA, opB, false, true>(n, scalar, A, B,
+                                                           C);
+}
+
+template <typename T, MatOp opA = MatOp::NORMAL, MatOp opB = MatOp::NORMAL>
+inline void MatMatMultCore3x3ScaleAddBatch(const index_t n, const T scalar,
+                                           const T A[], const T B[], T C[]) {
+  MatMatMultCore3x3BatchDispatch<T, opA, opB, true, true>(n, scalar, A, B, C);
+}
+
+}  // namespace A2D
+
+#endif  // A2D_GEMM_CORE_BATCH_H
@@ -2,36 +2,48 @@
 #define A2D_MAT_DET_CORE_H
 
 #include "../../a2ddefs.h"
+#include "a2dmatlucore.h"
 
 namespace A2D {
 
+/*
+  For N >= 4 the determinant is computed from the LU factorization and its
+  derivatives use d(det) = det * tr(A^{-1} * dA), so A must be nonsingular
+*/
 template <typename T, int N>
-A2D_FUNCTION T MatDetCore(const T A[]) {
-  static_assert((N >= 1 && N <= 3), "MatDet not implemented for N >= 4");
+A2D_FUNCTION T MatDetInvCore(const T A[], T Ainv[]) {
+  T LU[N * N], perm[N], sign;
+  MatLUFactorCore<T, N>(A, LU, perm, sign);
+  MatLUInverseCore<T, N>(LU, perm, Ainv);
+  return MatLUDetCore<T, N>(LU, sign);
+}
 
+template <typename T, int N>
+A2D_FUNCTION T MatDetCore(const T A[]) {
   if constexpr (N == 1) {
     return A[0];
   } else if constexpr (N == 2) {
     return A[0] * A[3] - A[1] * A[2];
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T det = (A[8] * (A[0] * A[4] - A[3] * A[1]) -
              A[7] * (A[0] * A[5] - A[3] * A[2]) +
              A[6] * (A[1] * A[5] - A[2] * A[4]));
     return det;
+  } else {
+    T LU[N * N], perm[N], sign;
+    MatLUFactorCore<T, N>(A, LU, perm, sign);
+    return MatLUDetCore<T, N>(LU, sign);
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION T MatDetForwardCore(const T A[], const T Ad[]) {
-  static_assert((N >= 1 && N <= 3),
-                "MatDetForwardCore not implemented for N >= 4");
-
   if constexpr (N == 1) {
     return Ad[0];
   } else if constexpr (N == 2) {
     T detd = Ad[0] * A[3] + A[0] * Ad[3] - Ad[1] * A[2] - A[1] * Ad[2];
     return detd;
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T detd = (Ad[0] * (A[8] * A[4] - A[7] * A[5]) +
               Ad[1] * (A[6] * A[5] - A[8] * A[3]) +
               Ad[2] * (A[7] * A[3] - A[6] * A[4]) +
@@ -42,14 +54,21 @@ A2D_FUNCTION T MatDetForwardCore(const T A[], const T Ad[]) {
               Ad[7] * (A[3] * A[2] - A[0] * A[5]) +
               Ad[8] * (A[0] * A[4] - A[3] * A[1]));
     return detd;
+  } else {
+    T Ainv[N * N];
+    T det = MatDetInvCore<T, N>(A, Ainv);
+    T trace = 0.0;
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        trace += Ainv[N * j + i] * Ad[N * i + j];
+      }
+    }
+    return det * trace;
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION void MatDetReverseCore(const T bdet, const T A[], T Ab[]) {
-  static_assert((N >= 1 && N <= 3),
-                "MatDetReverseCore not implemented for N >= 4");
-
   if constexpr (N == 1) {
     Ab[0] += bdet;
   } else if constexpr (N == 2) {
@@ -67,6 +86,14 @@ A2D_FUNCTION void MatDetReverseCore(const T bdet, const T A[], T Ab[]) {
     Ab[6] += (A[1] * A[5] - A[2] * A[4]) * bdet;
     Ab[7] += (A[3] * A[2] - A[0] * A[5]) * bdet;
     Ab[8] += (A[0] * A[4] - A[3] * A[1]) * bdet;
+  } else {
+    T Ainv[N * N];
+    T scale = bdet * MatDetInvCore<T, N>(A, Ainv);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        Ab[N * i + j] += scale * Ainv[N * j + i];
+      }
+    }
   }
 }
 
@@ -105,36 +132,63 @@ A2D_FUNCTION void MatDetHReverseCore(const T bdet, const T hdet, const T A[],
     Ah[6] += (A[1] * A[5] - A[2] * A[4]) * hdet;
     Ah[7] += (A[3] * A[2] - A[0] * A[5]) * hdet;
     Ah[8] += (A[0] * A[4] - A[3] * A[1]) * hdet;
+  } else {
+    // Ah += (hdet * det + bdet * det * tr(A^{-1} * Ap)) * A^{-T}
+    //       - bdet * det * (A^{-1} * Ap * A^{-1})^{T}
+    T Ainv[N * N], temp[N * N];
+    T det = MatDetInvCore<T, N>(A, Ainv);
+
+    T trace = 0.0;
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        T value = 0.0;
+        for (int k = 0; k < N; k++) {
+          value += Ainv[N * i + k] * Ap[N * k + j];
+        }
+        temp[N * i + j] = value;
+      }
+      trace += temp[N * i + i];
+    }
+
+    T scale = det * (hdet + bdet * trace);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        T value = 0.0;
+        for (int k = 0; k < N; k++) {
+          value += temp[N * j + k] * Ainv[N * k + i];
+        }
+        Ah[N * i + j] += scale * Ainv[N * j + i] - bdet * det * value;
+      }
+    }
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION T SymMatDetCore(const T S[]) {
-  static_assert((N >= 1 && N <= 3), "SymMatDet not implemented for N >= 4");
-
   if constexpr (N == 1) {
     return S[0];
   } else if constexpr (N == 2) {
     return S[0] * S[2] - S[1] * S[1];
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T det = (S[5] * (S[0] * S[2] - S[1] * S[1]) -
              S[4] * (S[0] * S[4] - S[3] * S[1]) +
              S[3] * (S[1] * S[4] - S[3] * S[2]));
     return det;
+  } else {
+    T A[N * N];
+    SymMatToMatCore<T, N>(S, A);
+    return MatDetCore<T, N>(A);
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION T SymMatDetForwardCore(const T S[], const T Sd[]) {
-  static_assert((N >= 1 && N <= 3),
-                "MatDetForwardCore not implemented for N >= 4");
-
   if constexpr (N == 1) {
     return Sd[0];
   } else if constexpr (N == 2) {
     T detd = Sd[0] * S[2] + S[0] * Sd[2] - Sd[1] * S[1] - S[1] * Sd[1];
     return detd;
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T detd = (Sd[0] * (S[5] * S[2] - S[4] * S[4]) +
               Sd[1] * (S[3] * S[4] - S[5] * S[1]) +
               Sd[3] * (S[4] * S[1] - S[3] * S[2]) +
@@ -145,14 +199,16 @@ A2D_FUNCTION T SymMatDetForwardCore(const T S[], const T Sd[]) {
               Sd[4] * (S[1] * S[3] - S[0] * S[4]) +
               Sd[5] * (S[0] * S[2] - S[1] * S[1]));
     return detd;
+  } else {
+    T A[N * N], Ad[N * N];
+    SymMatToMatCore<T, N>(S, A);
+    SymMatToMatCore<T, N>(Sd, Ad);
+    return MatDetForwardCore<T, N>(A, Ad);
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION void SymMatDetReverseCore(const T bdet, const T S[], T Sb[]) {
-  static_assert((N >= 1 && N <= 3),
-                "MatDetReverseCore not implemented for N >= 4");
-
   if constexpr (N == 1) {
     Sb[0] += bdet;
   } else if constexpr (N == 2) {
@@ -166,6 +222,14 @@ A2D_FUNCTION void SymMatDetReverseCore(const T bdet, const T S[], T Sb[]) {
     Sb[2] += (S[5] * S[0] - S[3] * S[3]) * bdet;
     Sb[4] += 2.0 * (S[3] * S[1] - S[4] * S[0]) * bdet;
     Sb[5] += (S[0] * S[2] - S[1] * S[1]) * bdet;
+  } else {
+    T A[N * N], Ab[N * N];
+    SymMatToMatCore<T, N>(S, A);
+    for (int i = 0; i < N * N; i++) {
+      Ab[i] = 0.0;
+    }
+    MatDetReverseCore<T, N>(bdet, A, Ab);
+    MatToSymMatAddCore<T, N>(Ab, Sb);
   }
 }
 
@@ -199,6 +263,15 @@ A2D_FUNCTION void SymMatDetHReverseCore(const T bdet, const T hdet, const T S[],
     Sh[2] += (S[5] * S[0] - S[3] * S[3]) * hdet;
     Sh[4] += 2.0 * (S[3] * S[1] - S[4] * S[0]) * hdet;
     Sh[5] += (S[0] * S[2] - S[1] * S[1]) * hdet;
+  } else {
+    T A[N * N], Ap[N * N], Ah[N * N];
+    SymMatToMatCore<T, N>(S, A);
+    SymMatToMatCore<T, N>(Sp, Ap);
+    for (int i = 0; i < N * N; i++) {
+      Ah[i] = 0.0;
+    }
+    MatDetHReverseCore<T, N>(bdet, hdet, A, Ap, Ah);
+    MatToSymMatAddCore<T, N>(Ah, Sh);
   }
 }
 
@@ -2,12 +2,13 @@
 #define A2D_MAT_INV_CORE_H
 
 #include "../../a2ddefs.h"
+#include "a2dmatlucore.h"
 
 namespace A2D {
 
 template <typename T, int N>
 A2D_FUNCTION void MatInvCore(const T A[], T Ainv[]) {
-  static_assert((N >= 1 && N <= 3), "MatInvCore not implemented for N >= 4");
+  static_assert(N >= 1, "MatInvCore requires N >= 1");
 
   if constexpr (N == 1) {
     Ainv[0] = 1.0 / A[0];
@@ -19,7 +20,7 @@ A2D_FUNCTION void MatInvCore(const T A[], T Ainv[]) {
     Ainv[1] = -A[1] * detinv;
     Ainv[2] = -A[2] * detinv;
     Ainv[3] = A[0] * detinv;
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T det = (A[8] * (A[0] * A[4] - A[3] * A[1]) -
              A[7] * (A[0] * A[5] - A[3] * A[2]) +
              A[6] * (A[1] * A[5] - A[2] * A[4]));
@@ -36,12 +37,16 @@ A2D_FUNCTION void MatInvCore(const T A[], T Ainv[]) {
     Ainv[6] = (A[3] * A[7] - A[4] * A[6]) * detinv;
     Ainv[7] = -1.0 * (A[0] * A[7] - A[1] * A[6]) * detinv;
     Ainv[8] = (A[0] * A[4] - A[1] * A[3]) * detinv;
+  } else {  // N >= 4, use the LU factorization
+    T LU[N * N], perm[N], sign;
+    MatLUFactorCore<T, N>(A, LU, perm, sign);
+    MatLUInverseCore<T, N>(LU, perm, Ainv);
   }
 }
 
 template <typename T, int N>
 A2D_FUNCTION void SymMatInvCore(const T S[], T Sinv[]) {
-  static_assert((N >= 1 && N <= 3), "MatInvCore not implemented for N >= 4");
+  static_assert(N >= 1, "SymMatInvCore requires N >= 1");
 
   if constexpr (N == 1) {
     Sinv[0] = 1.0 / S[0];
@@ -52,7 +57,7 @@ A2D_FUNCTION void SymMatInvCore(const T S[], T Sinv[]) {
     Sinv[0] = S[2] * detinv;
     Sinv[1] = -S[1] * detinv;
     Sinv[2] = S[0] * detinv;
-  } else {  // N == 3
+  } else if constexpr (N == 3) {
     T det = (S[5] * (S[0] * S[2] - S[1] * S[1]) -
              S[4] * (S[0] * S[4] - S[1] * S[3]) +
              S[3] * (S[1] * S[4] - S[3] * S[2]));
@@ -66,6 +71,15 @@ A2D_FUNCTION void SymMatInvCore(const T S[], T Sinv[]) {
     Sinv[4] = -(S[0] * S[4] - S[3] * S[1]) * detinv;
 
     Sinv[5] = (S[0] * S[2] - S[1] * S[1]) * detinv;
+  } else {  // N >= 4, invert the full matrix and keep the lower triangle
+    T A[N * N], Ainv[N * N];
+    SymMatToMatCore<T, N>(S, A);
+    MatInvCore<T, N>(A, Ainv);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j <= i; j++) {
+        Sinv[j + i * (i + 1) / 2] = Ainv[N * i + j];
+      }
+    }
   }
 }
 
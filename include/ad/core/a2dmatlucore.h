@@ -0,0 +1,211 @@
+#ifndef A2D_MAT_LU_CORE_H
+#define A2D_MAT_LU_CORE_H
+
+#include "../../a2ddefs.h"
+
+namespace A2D {
+
+/*
+  LU factorization with partial pivoting of a small dense matrix
+
+  P * A = L * U
+
+  The factors are stored in LU in row-major order: L is unit lower triangular
+  and is stored below the diagonal, U is stored on and above the diagonal.
+  Row k of P * A is row perm[k] of A and sign = det(P).
+
+  The pivot is the entry in the column with the largest real part magnitude.
+  Rows are interchanged with select() instead of branching on the pivot
+  index, so the same code applies to the lane-pack numeric type where each
+  lane pivots independently. This is also why the permutation is stored with
+  the numeric type T. The interchange is skipped when no lane needs it.
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatLUFactorCore(const T A[], T LU[], T perm[], T& sign) {
+  for (int i = 0; i < N * N; i++) {
+    LU[i] = A[i];
+  }
+  for (int i = 0; i < N; i++) {
+    perm[i] = T(i);
+  }
+  sign = T(1.0);
+
+  for (int k = 0; k < N; k++) {
+    // Move the largest entry on or below the diagonal in column k to row k
+    for (int i = k + 1; i < N; i++) {
+      auto swap = absfunc(LU[N * i + k]) > absfunc(LU[N * k + k]);
+      if (any(swap)) {
+        for (int j = 0; j < N; j++) {
+          T t = LU[N * k + j];
+          LU[N * k + j] = select(swap, LU[N * i + j], t);
+          LU[N * i + j] = select(swap, t, LU[N * i + j]);
+        }
+        T t = perm[k];
+        perm[k] = select(swap, perm[i], t);
+        perm[i] = select(swap, t, perm[i]);
+        sign = select(swap, T(-sign), sign);
+      }
+    }
+
+    // Eliminate the entries below the diagonal
+    T inv = 1.0 / LU[N * k + k];
+    for (int i = k + 1; i < N; i++) {
+      T l = LU[N * i + k] * inv;
+      LU[N * i + k] = l;
+      for (int j = k + 1; j < N; j++) {
+        LU[N * i + j] -= l * LU[N * k + j];
+      }
+    }
+  }
+}
+
+/*
+  Compute the determinant from the LU factorization
+*/
+template <typename T, int N>
+A2D_FUNCTION T MatLUDetCore(const T LU[], const T sign) {
+  T det = sign;
+  for (int k = 0; k < N; k++) {
+    det *= LU[N * k + k];
+  }
+  return det;
+}
+
+/*
+  Solve L * U * x = y in place, where y = P * b is the permuted right-hand side
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatLUSolvePermutedCore(const T LU[], T x[]) {
+  // Solve L * y = P * b
+  for (int i = 1; i < N; i++) {
+    for (int j = 0; j < i; j++) {
+      x[i] -= LU[N * i + j] * x[j];
+    }
+  }
+
+  // Solve U * x = y
+  for (int i = N - 1; i >= 0; i--) {
+    for (int j = i + 1; j < N; j++) {
+      x[i] -= LU[N * i + j] * x[j];
+    }
+    x[i] = x[i] / LU[N * i + i];
+  }
+}
+
+/*
+  Solve A * x = b using the LU factorization. x and b must not overlap.
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatLUSolveCore(const T LU[], const T perm[], const T b[],
+                                 T x[]) {
+  // x = P * b, x[k] = b[perm[k]]
+  for (int k = 0; k < N; k++) {
+    x[k] = b[0];
+    for (int i = 1; i < N; i++) {
+      x[k] = select(RealPart(perm[k]) == double(i), b[i], x[k]);
+    }
+  }
+  MatLUSolvePermutedCore<T, N>(LU, x);
+}
+
+/*
+  Solve A^{T} * x = b using the LU factorization. x and b must not overlap.
+
+  A^{T} = U^{T} * L^{T} * P
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatLUSolveTransposeCore(const T LU[], const T perm[],
+                                          const T b[], T x[]) {
+  T w[N];
+
+  // Solve U^{T} * z = b
+  for (int i = 0; i < N; i++) {
+    w[i] = b[i];
+    for (int j = 0; j < i; j++) {
+      w[i] -= LU[N * j + i] * w[j];
+    }
+    w[i] = w[i] / LU[N * i + i];
+  }
+
+  // Solve L^{T} * w = z
+  for (int i = N - 2; i >= 0; i--) {
+    for (int j = i + 1; j < N; j++) {
+      w[i] -= LU[N * j + i] * w[j];
+    }
+  }
+
+  // x = P^{T} * w, x[perm[k]] = w[k]
+  for (int i = 0; i < N; i++) {
+    x[i] = w[0];
+    for (int k = 1; k < N; k++) {
+      x[i] = select(RealPart(perm[k]) == double(i), w[k], x[i]);
+    }
+  }
+}
+
+/*
+  Compute the inverse of A from its LU factorization
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatLUInverseCore(const T LU[], const T perm[], T Ainv[]) {
+  T dinv[N];
+  for (int i = 0; i < N; i++) {
+    dinv[i] = 1.0 / LU[N * i + i];
+  }
+
+  for (int j = 0; j < N; j++) {
+    // Column j of P
+    T x[N];
+    for (int k = 0; k < N; k++) {
+      x[k] = select(RealPart(perm[k]) == double(j), T(1.0), T(0.0));
+    }
+
+    for (int i = 1; i < N; i++) {
+      for (int k = 0; k < i; k++) {
+        x[i] -= LU[N * i + k] * x[k];
+      }
+    }
+    for (int i = N - 1; i >= 0; i--) {
+      for (int k = i + 1; k < N; k++) {
+        x[i] -= LU[N * i + k] * x[k];
+      }
+      x[i] *= dinv[i];
+    }
+
+    for (int i = 0; i < N; i++) {
+      Ainv[N * i + j] = x[i];
+    }
+  }
+}
+
+/*
+  Expand the packed lower-triangular storage of a symmetric matrix to a full
+  row-major matrix
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatToMatCore(const T S[], T A[]) {
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++) {
+      A[N * i + j] = A[N * j + i] = S[j + i * (i + 1) / 2];
+    }
+  }
+}
+
+/*
+  Add the derivative with respect to the entries of a full matrix to the
+  derivative with respect to the packed entries of a symmetric matrix. Each
+  off-diagonal entry of S appears twice in the full matrix.
+*/
+template <typename T, int N>
+A2D_FUNCTION void MatToSymMatAddCore(const T Ab[], T Sb[]) {
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < i; j++) {
+      Sb[j + i * (i + 1) / 2] += Ab[N * i + j] + Ab[N * j + i];
+    }
+    Sb[i + i * (i + 1) / 2] += Ab[N * i + i];
+  }
+}
+
+}  // namespace A2D
+
+#endif  // A2D_MAT_LU_CORE_H
@@ -0,0 +1,272 @@
+#ifndef A2D_SYM_CHOL_CORE_H
+#define A2D_SYM_CHOL_CORE_H
+
+#include "../../a2ddefs.h"
+#include "a2dmatlucore.h"
+
+namespace A2D {
+
+/*
+  Cholesky factorization S = L * L^{T} of a symmetric positive definite
+  matrix in the packed lower-triangular SymMat storage
+
+  Entry (i, j) with i >= j of both S and L is stored at j + i * (i + 1) / 2.
+  Each entry of S is read once, immediately before the same entry of L is
+  written, so the factorization may be computed in place (S == L).
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholFactorCore(const T S[], T L[]) {
+  for (int i = 0; i < N; i++) {
+    const int ii = i * (i + 1) / 2;
+    for (int j = 0; j <= i; j++) {
+      const int jj = j * (j + 1) / 2;
+      T value = S[ii + j];
+      for (int k = 0; k < j; k++) {
+        value -= L[ii + k] * L[jj + k];
+      }
+      if (j < i) {
+        L[ii + j] = value / L[jj + j];
+      } else {
+        L[ii + i] = sqrt(value);
+      }
+    }
+  }
+}
+
+/*
+  Solve L * L^{T} * x = b with the packed Cholesky factor. x may be equal to
+  b.
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholSolveCore(const T L[], const T b[], T x[]) {
+  // Solve L * y = b
+  for (int i = 0; i < N; i++) {
+    const int ii = i * (i + 1) / 2;
+    T value = b[i];
+    for (int k = 0; k < i; k++) {
+      value -= L[ii + k] * x[k];
+    }
+    x[i] = value / L[ii + i];
+  }
+
+  // Solve L^{T} * x = y
+  for (int i = N - 1; i >= 0; i--) {
+    T value = x[i];
+    for (int k = i + 1; k < N; k++) {
+      value -= L[i + k * (k + 1) / 2] * x[k];
+    }
+    x[i] = value / L[i + i * (i + 1) / 2];
+  }
+}
+
+/*
+  Compute y = L * x or y = L^{T} * x with the packed lower-triangular L
+*/
+template <typename T, int N, MatOp op = MatOp::NORMAL>
+A2D_FUNCTION void SymMatCholMultCore(const T L[], const T x[], T y[]) {
+  if constexpr (op == MatOp::NORMAL) {
+    for (int i = 0; i < N; i++) {
+      const int ii = i * (i + 1) / 2;
+      T value = 0.0;
+      for (int k = 0; k <= i; k++) {
+        value += L[ii + k] * x[k];
+      }
+      y[i] = value;
+    }
+  } else {
+    for (int i = 0; i < N; i++) {
+      T value = 0.0;
+      for (int k = i; k < N; k++) {
+        value += L[i + k * (k + 1) / 2] * x[k];
+      }
+      y[i] = value;
+    }
+  }
+}
+
+/*
+  Add the lower triangle of alpha * x * y^{T} to the packed matrix L
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholOuterAddCore(const T alpha, const T x[],
+                                         const T y[], T L[]) {
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++, L++) {
+      L[0] += alpha * x[i] * y[j];
+    }
+  }
+}
+
+/*
+  Compute A = L^{-1} * A in place, where A is a full N x N row-major matrix
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholLowerSolveCore(const T L[], T A[]) {
+  for (int i = 0; i < N; i++) {
+    const int ii = i * (i + 1) / 2;
+    for (int k = 0; k < i; k++) {
+      for (int j = 0; j < N; j++) {
+        A[N * i + j] -= L[ii + k] * A[N * k + j];
+      }
+    }
+    T inv = 1.0 / L[ii + i];
+    for (int j = 0; j < N; j++) {
+      A[N * i + j] *= inv;
+    }
+  }
+}
+
+/*
+  Compute A = L^{-T} * A in place, where A is a full N x N row-major matrix
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholUpperSolveCore(const T L[], T A[]) {
+  for (int i = N - 1; i >= 0; i--) {
+    for (int k = i + 1; k < N; k++) {
+      const T l = L[i + k * (k + 1) / 2];
+      for (int j = 0; j < N; j++) {
+        A[N * i + j] -= l * A[N * k + j];
+      }
+    }
+    T inv = 1.0 / L[i + i * (i + 1) / 2];
+    for (int j = 0; j < N; j++) {
+      A[N * i + j] *= inv;
+    }
+  }
+}
+
+/*
+  Compute B = L^{-T} * A * L^{-1} = L^{-T} * (L^{-T} * A^{T})^{T}
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholCongruenceCore(const T L[], const T A[], T B[]) {
+  T temp[N * N];
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      temp[N * i + j] = A[N * j + i];
+    }
+  }
+  SymMatCholUpperSolveCore<T, N>(L, temp);
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      B[N * i + j] = temp[N * j + i];
+    }
+  }
+  SymMatCholUpperSolveCore<T, N>(L, B);
+}
+
+/*
+  Compute Phi(L^{T} * Lb), the lower triangle of L^{T} * Lb with the diagonal
+  halved, as a full row-major matrix. L and Lb are packed lower triangular.
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholPhiCore(const T L[], const T Lb[], T P[]) {
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      T value = 0.0;
+      if (j <= i) {
+        for (int k = i; k < N; k++) {
+          value += L[i + k * (k + 1) / 2] * Lb[j + k * (k + 1) / 2];
+        }
+        if (j == i) {
+          value *= 0.5;
+        }
+      }
+      P[N * i + j] = value;
+    }
+  }
+}
+
+/*
+  Forward derivative of the Cholesky factor
+
+  dot{L} = L * Phi(L^{-1} * dot{S} * L^{-T})
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholForwardCore(const T L[], const T Sd[], T Ld[]) {
+  // M = L^{-1} * Sd * L^{-T} = L^{-1} * (L^{-1} * Sd)^{T}
+  T M[N * N], temp[N * N];
+  SymMatToMatCore<T, N>(Sd, temp);
+  SymMatCholLowerSolveCore<T, N>(L, temp);
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      M[N * i + j] = temp[N * j + i];
+    }
+  }
+  SymMatCholLowerSolveCore<T, N>(L, M);
+
+  // Ld = L * Phi(M) is lower triangular
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++) {
+      T value = 0.5 * L[j + i * (i + 1) / 2] * M[N * j + j];
+      for (int k = j + 1; k <= i; k++) {
+        value += L[k + i * (i + 1) / 2] * M[N * k + j];
+      }
+      Ld[j + i * (i + 1) / 2] = value;
+    }
+  }
+}
+
+/*
+  Reverse derivative of the Cholesky factor
+
+  Sb += sym(L^{-T} * Phi(L^{T} * Lb) * L^{-1})
+
+  where sym() adds the (i, j) and (j, i) entries for the packed storage
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholReverseCore(const T L[], const T Lb[], T Sb[]) {
+  T P[N * N], G[N * N];
+  SymMatCholPhiCore<T, N>(L, Lb, P);
+  SymMatCholCongruenceCore<T, N>(L, P, G);
+  MatToSymMatAddCore<T, N>(G, Sb);
+}
+
+/*
+  Second-order reverse derivative of the Cholesky factor
+
+  With F = Phi(L^{T} * Lb) and E = L^{-1} * Lp,
+
+  Sh += sym(L^{-T} * (Phi(L^{T} * Lh + Lp^{T} * Lb) - E^{T} * F - F * E) *
+            L^{-1})
+*/
+template <typename T, int N>
+A2D_FUNCTION void SymMatCholHReverseCore(const T L[], const T Lp[],
+                                         const T Lb[], const T Lh[], T Sh[]) {
+  T F[N * N], E[N * N], P[N * N], G[N * N];
+
+  // P = Phi(L^{T} * Lh + Lp^{T} * Lb)
+  SymMatCholPhiCore<T, N>(L, Lh, P);
+  SymMatCholPhiCore<T, N>(Lp, Lb, G);
+  for (int i = 0; i < N * N; i++) {
+    P[i] += G[i];
+  }
+
+  // E = L^{-1} * Lp
+  SymMatToMatCore<T, N>(Lp, E);
+  for (int i = 0; i < N; i++) {
+    for (int j = i + 1; j < N; j++) {
+      E[N * i + j] = 0.0;
+    }
+  }
+  SymMatCholLowerSolveCore<T, N>(L, E);
+
+  // P -= E^{T} * F + F * E
+  SymMatCholPhiCore<T, N>(L, Lb, F);
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      T value = 0.0;
+      for (int k = 0; k < N; k++) {
+        value += E[N * k + i] * F[N * k + j] + F[N * i + k] * E[N * k + j];
+      }
+      P[N * i + j] -= value;
+    }
+  }
+
+  SymMatCholCongruenceCore<T, N>(L, P, G);
+  MatToSymMatAddCore<T, N>(G, Sh);
+}
+
+}  // namespace A2D
+
+#endif  // A2D_SYM_CHOL_CORE_H
@@ -252,3 +252,49 @@ TEST(test_a2dgemmcore, rectangular_matrices) {
   run_single_test<true, MatOp::NORMAL, MatOp::NORMAL>(case7());
   run_single_test<true, MatOp::TRANSPOSE, MatOp::NORMAL>(case8());
 }
+
+// Sizes that reach the register-blocked kernel for at least one transpose
+// combination and exercise its full and remainder tiles
+template <bool additive, int M, int N, int P>
+void run_blocked_tests() {
+  using T = double;
+  run_single_test<additive, MatOp::NORMAL, MatOp::NORMAL>(
+      a2d_tuple<Mat<T, M, P>, Mat<T, P, N>, Mat<T, M, N>>());
+  run_single_test<additive, MatOp::TRANSPOSE, MatOp::NORMAL>(
+      a2d_tuple<Mat<T, P, M>, Mat<T, P, N>, Mat<T, M, N>>());
+  run_single_test<additive, MatOp::NORMAL, MatOp::TRANSPOSE>(
+      a2d_tuple<Mat<T, M, P>, Mat<T, N, P>, Mat<T, M, N>>());
+  run_single_test<additive, MatOp::TRANSPOSE, MatOp::TRANSPOSE>(
+      a2d_tuple<Mat<T, P, M>, Mat<T, N, P>, Mat<T, M, N>>());
+}
+
+TEST(test_a2dgemmcore, blocked_matrices) {
+  // Regular and Scale
+  run_blocked_tests<false, 6, 6, 16>();
+  run_blocked_tests<false, 8, 24, 24>();
+  run_blocked_tests<false, 24, 24, 24>();
+  run_blocked_tests<false, 9, 10, 7>();
+  run_blocked_tests<false, 1, 18, 31>();
+
+  // Add and ScaleAdd
+  run_blocked_tests<true, 6, 6, 16>();
+  run_blocked_tests<true, 8, 24, 24>();
+  run_blocked_tests<true, 24, 24, 24>();
+  run_blocked_tests<true, 9, 10, 7>();
+  run_blocked_tests<true, 1, 18, 31>();
+}
+
+// The dispatch must keep the shapes where the naive loops were measured to be
+// faster on the naive path
+TEST(test_a2dgemmcore, blocked_dispatch) {
+  constexpr MatOp N = MatOp::NORMAL, T = MatOp::TRANSPOSE;
+  EXPECT_TRUE((MatMatMultUseBlocked<6, 6, 6, T, T>()));
+  EXPECT_FALSE((MatMatMultUseBlocked<6, 6, 6, N, N>()));
+  EXPECT_FALSE((MatMatMultUseBlocked<6, 6, 6, N, T>()));
+  EXPECT_FALSE((MatMatMultUseBlocked<8, 8, 8, T, T>()));
+  EXPECT_FALSE((MatMatMultUseBlocked<24, 24, 8, N, N>()));
+  EXPECT_FALSE((MatMatMultUseBlocked<24, 24, 8, T, N>()));
+  EXPECT_TRUE((MatMatMultUseBlocked<24, 24, 8, T, T>()));
+  EXPECT_TRUE((MatMatMultUseBlocked<8, 24, 24, N, N>()));
+  EXPECT_TRUE((MatMatMultUseBlocked<12, 12, 12, N, T>()));
+}
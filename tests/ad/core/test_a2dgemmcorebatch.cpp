@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ad/core/a2dgemmcorebatch.h"
+
+using namespace A2D;
+
+// Compare the batched kernels for each available instruction set against the
+// single-matrix kernels. The vectorized kernels use fused multiply-adds, so
+// the results agree to round-off only.
+template <MatOp opA, MatOp opB, bool additive, bool scale>
+void test_batch(const index_t n) {
+  const double alpha = 0.37;
+  std::vector<double> A(9 * n), B(9 * n), C0(9 * n), Cref(9 * n);
+  for (index_t i = 0; i < 9 * n; i++) {
+    A[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+    B[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+    C0[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+
+  Cref = C0;
+  for (index_t i = 0; i < n; i++) {
+    if constexpr (additive and scale) {
+      MatMatMultCore3x3ScaleAdd<double, opA, opB>(alpha, &A[9 * i], &B[9 * i],
+                                                  &Cref[9 * i]);
+    } else if constexpr (additive) {
+      MatMatMultCore3x3Add<double, opA, opB>(&A[9 * i], &B[9 * i],
+                                             &Cref[9 * i]);
+    } else if constexpr (scale) {
+      MatMatMultCore3x3Scale<double, opA, opB>(alpha, &A[9 * i], &B[9 * i],
+                                               &Cref[9 * i]);
+    } else {
+      MatMatMultCore3x3<double, opA, opB>(&A[9 * i], &B[9 * i], &Cref[9 * i]);
+    }
+  }
+
+  for (SimdISA isa : {SimdISA::SCALAR, SimdISA::AVX2, SimdISA::AVX512}) {
+    if (isa > GetSimdISA()) {
+      continue;
+    }
+    std::vector<double> C(C0);
+    MatMatMultCore3x3BatchISA<opA, opB, additive, scale>(
+        isa, n, alpha, A.data(), B.data(), C.data());
+    for (index_t i = 0; i < 9 * n; i++) {
+      EXPECT_NEAR(C[i], Cref[i], 1e-15);
+    }
+  }
+
+  // The dispatched entry points
+  std::vector<double> C(C0);
+  if constexpr (additive and scale) {
+    MatMatMultCore3x3ScaleAddBatch<double, opA, opB>(n, alpha, A.data(),
+                                                     B.data(), C.data());
+  } else if constexpr (additive) {
+    MatMatMultCore3x3AddBatch<double, opA, opB>(n, A.data(), B.data(),
+                                                C.data());
+  } else if constexpr (scale) {
+    MatMatMultCore3x3ScaleBatch<double, opA, opB>(n, alpha, A.data(),
+                                                  B.data(), C.data());
+  } else {
+    MatMatMultCore3x3Batch<double, opA, opB>(n, A.data(), B.data(), C.data());
+  }
+  for (index_t i = 0; i < 9 * n; i++) {
+    EXPECT_NEAR(C[i], Cref[i], 1e-15);
+  }
+}
+
+template <bool additive, bool scale>
+void test_all_ops(const index_t n) {
+  test_batch<MatOp::NORMAL, MatOp::NORMAL, additive, scale>(n);
+  test_batch<MatOp::TRANSPOSE, MatOp::NORMAL, additive, scale>(n);
+  test_batch<MatOp::NORMAL, MatOp::TRANSPOSE, additive, scale>(n);
+  test_batch<MatOp::TRANSPOSE, MatOp::TRANSPOSE, additive, scale>(n);
+}
+
+TEST(test_a2dgemmcorebatch, Regular) {
+  // 13 = 8 + 4 + 1 exercises every kernel and the remainder
+  test_all_ops<false, false>(13);
+  test_all_ops<false, false>(3);
+}
+
+TEST(test_a2dgemmcorebatch, Add) {
+  test_all_ops<true, false>(13);
+  test_all_ops<true, false>(3);
+}
+
+TEST(test_a2dgemmcorebatch, Scale) {
+  test_all_ops<false, true>(13);
+  test_all_ops<false, true>(3);
+}
+
+TEST(test_a2dgemmcorebatch, ScaleAdd) {
+  test_all_ops<true, true>(13);
+  test_all_ops<true, true>(3);
+}
+
+TEST(test_a2dgemmcorebatch, Complex) {
+  using T = A2D_complex_t<double>;
+  const index_t n = 5;
+  std::vector<T> A(9 * n), B(9 * n), C(9 * n), Cref(9 * n);
+  for (index_t i = 0; i < 9 * n; i++) {
+    A[i] = T(rand() % 7 - 3.0, 0.25 * (rand() % 5));
+    B[i] = T(rand() % 7 - 3.0, 0.5 * (rand() % 3));
+  }
+  MatMatMultCore3x3Batch<T, MatOp::TRANSPOSE, MatOp::NORMAL>(n, A.data(),
+                                                            B.data(), C.data());
+  for (index_t i = 0; i < n; i++) {
+    MatMatMultCore3x3<T, MatOp::TRANSPOSE, MatOp::NORMAL>(
+        &A[9 * i], &B[9 * i], &Cref[9 * i]);
+  }
+  for (index_t i = 0; i < 9 * n; i++) {
+    EXPECT_DOUBLE_EQ(C[i].real(), Cref[i].real());
+    EXPECT_DOUBLE_EQ(C[i].imag(), Cref[i].imag());
+  }
+}
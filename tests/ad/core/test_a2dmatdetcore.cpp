@@ -80,7 +80,7 @@ void test_mat_det_reverse_core() {
       if (i == j) {
         EXPECT_DOUBLE_EQ(Ab(i, j), Sb(i, j));
       } else {
-        EXPECT_DOUBLE_EQ(2.0 * Ab(i, j), Sb(i, j));
+        EXPECT_DOUBLE_EQ(Ab(i, j) + Ab(j, i), Sb(i, j));
       }
     }
   }
@@ -116,7 +116,7 @@ void test_mat_det_hreverse_core() {
       if (i == j) {
         EXPECT_DOUBLE_EQ(Ah(i, j), Sh(i, j));
       } else {
-        EXPECT_DOUBLE_EQ(2.0 * Ah(i, j), Sh(i, j));
+        EXPECT_DOUBLE_EQ(Ah(i, j) + Ah(j, i), Sh(i, j));
       }
     }
   }
@@ -126,22 +126,34 @@ TEST(test_a2dmatdetcore, MatDetCore) {
   test_mat_det_core<1>();
   test_mat_det_core<2>();
   test_mat_det_core<3>();
+  test_mat_det_core<4>();
+  test_mat_det_core<5>();
+  test_mat_det_core<6>();
 }
 
 TEST(test_a2dmatdetcore, MatDetForwardCore) {
   test_mat_det_forward_core<1>();
   test_mat_det_forward_core<2>();
   test_mat_det_forward_core<3>();
+  test_mat_det_forward_core<4>();
+  test_mat_det_forward_core<5>();
+  test_mat_det_forward_core<6>();
 }
 
 TEST(test_a2dmatdetcore, MatDetReverseCore) {
   test_mat_det_reverse_core<1>();
   test_mat_det_reverse_core<2>();
   test_mat_det_reverse_core<3>();
+  test_mat_det_reverse_core<4>();
+  test_mat_det_reverse_core<5>();
+  test_mat_det_reverse_core<6>();
 }
 
 TEST(test_a2dmatdetcore, MatDetHReverseCore) {
   test_mat_det_hreverse_core<1>();
   test_mat_det_hreverse_core<2>();
   test_mat_det_hreverse_core<3>();
+  test_mat_det_hreverse_core<4>();
+  test_mat_det_hreverse_core<5>();
+  test_mat_det_hreverse_core<6>();
 }
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "ad/a2dmat.h"
+#include "ad/a2dobj.h"
+#include "ad/core/a2dmatdetcore.h"
+#include "ad/core/a2dmatinvcore.h"
+#include "ad/core/a2dmatlucore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+template <int N>
+void random_matrix(Mat<double, N, N>& A) {
+  for (int i = 0; i < N * N; i++) {
+    A[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+}
+
+// Determinant by cofactor expansion along the first row
+template <int N>
+double cofactor_det(const double A[]) {
+  if constexpr (N == 1) {
+    return A[0];
+  } else {
+    double det = 0.0, sign = 1.0;
+    for (int k = 0; k < N; k++) {
+      double minor[(N - 1) * (N - 1)];
+      for (int i = 1; i < N; i++) {
+        for (int j = 0, jj = 0; j < N; j++) {
+          if (j != k) {
+            minor[(N - 1) * (i - 1) + jj] = A[N * i + j];
+            jj++;
+          }
+        }
+      }
+      det += sign * A[k] * cofactor_det<N - 1>(minor);
+      sign = -sign;
+    }
+    return det;
+  }
+}
+
+template <int N>
+void test_lu_det_inv() {
+  Mat<double, N, N> A, Ainv;
+  random_matrix(A);
+
+  double det = MatDetCore<double, N>(get_data(A));
+  EXPECT_NEAR(det, cofactor_det<N>(get_data(A)), 1e-14);
+
+  // A * A^{-1} = I
+  MatInvCore<double, N>(get_data(A), get_data(Ainv));
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      double value = 0.0;
+      for (int k = 0; k < N; k++) {
+        value += A(i, k) * Ainv(k, j);
+      }
+      EXPECT_NEAR(value, (i == j ? 1.0 : 0.0), 1e-12);
+    }
+  }
+}
+
+template <int N>
+void test_lu_solve() {
+  Mat<double, N, N> A, LU;
+  double perm[N], sign, b[N], x[N], xt[N];
+  random_matrix(A);
+  for (int i = 0; i < N; i++) {
+    b[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+
+  MatLUFactorCore<double, N>(get_data(A), get_data(LU), perm, sign);
+  MatLUSolveCore<double, N>(get_data(LU), perm, b, x);
+  MatLUSolveTransposeCore<double, N>(get_data(LU), perm, b, xt);
+
+  for (int i = 0; i < N; i++) {
+    double value = 0.0, valuet = 0.0;
+    for (int j = 0; j < N; j++) {
+      value += A(i, j) * x[j];
+      valuet += A(j, i) * xt[j];
+    }
+    EXPECT_NEAR(value, b[i], 1e-12);
+    EXPECT_NEAR(valuet, b[i], 1e-12);
+  }
+}
+
+// A matrix that requires row interchanges: a zero leading entry
+TEST(test_a2dmatlucore, Pivoting) {
+  constexpr int N = 4;
+  const double vals[] = {0.0, 1.0, 2.0, 3.0, 1.0, 0.0, 1.0, 2.0,
+                         4.0, 1.0, 0.0, 1.0, 2.0, 3.0, 1.0, 0.0};
+  Mat<double, N, N> A(vals), Ainv;
+  double det = MatDetCore<double, N>(get_data(A));
+  EXPECT_NEAR(det, cofactor_det<N>(vals), 1e-13);
+
+  MatInvCore<double, N>(get_data(A), get_data(Ainv));
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      double value = 0.0;
+      for (int k = 0; k < N; k++) {
+        value += A(i, k) * Ainv(k, j);
+      }
+      EXPECT_NEAR(value, (i == j ? 1.0 : 0.0), 1e-13);
+    }
+  }
+}
+
+TEST(test_a2dmatlucore, DetInv) {
+  test_lu_det_inv<4>();
+  test_lu_det_inv<5>();
+  test_lu_det_inv<6>();
+}
+
+TEST(test_a2dmatlucore, Solve) {
+  test_lu_solve<2>();
+  test_lu_solve<3>();
+  test_lu_solve<4>();
+  test_lu_solve<5>();
+  test_lu_solve<6>();
+}
+
+TEST(test_a2dmatlucore, SymMatInv) {
+  constexpr int N = 5;
+  SymMat<double, N> S, Sinv;
+  for (int i = 0; i < S.ncomp; i++) {
+    S[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+  SymMatInvCore<double, N>(get_data(S), get_data(Sinv));
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      double value = 0.0;
+      for (int k = 0; k < N; k++) {
+        value += S(i, k) * Sinv(k, j);
+      }
+      EXPECT_NEAR(value, (i == j ? 1.0 : 0.0), 1e-12);
+    }
+  }
+}
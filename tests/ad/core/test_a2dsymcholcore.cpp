@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "ad/a2dmat.h"
+#include "ad/a2dobj.h"
+#include "ad/core/a2dmatlucore.h"
+#include "ad/core/a2dsymcholcore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+// Random symmetric positive definite matrix
+template <int N>
+void random_spd_matrix(SymMat<double, N>& S) {
+  for (int i = 0; i < S.ncomp; i++) {
+    S[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+  for (int i = 0; i < N; i++) {
+    S(i, i) += N;
+  }
+}
+
+template <int N>
+void test_factor() {
+  SymMat<double, N> S, L, Lin;
+  random_spd_matrix(S);
+
+  SymMatCholFactorCore<double, N>(get_data(S), get_data(L));
+
+  // The factorization in place gives the same factor
+  Lin = S;
+  SymMatCholFactorCore<double, N>(get_data(Lin), get_data(Lin));
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++) {
+      double value = 0.0;
+      for (int k = 0; k <= j; k++) {
+        value += L(i, k) * L(j, k);
+      }
+      EXPECT_NEAR(value, S(i, j), 1e-14);
+      EXPECT_DOUBLE_EQ(L(i, j), Lin(i, j));
+    }
+  }
+}
+
+template <int N>
+void test_solve() {
+  SymMat<double, N> S, L;
+  random_spd_matrix(S);
+  SymMatCholFactorCore<double, N>(get_data(S), get_data(L));
+
+  double b[N], x[N], y[N];
+  for (int i = 0; i < N; i++) {
+    b[i] = static_cast<double>(rand()) / RAND_MAX;
+  }
+
+  // Compare against the LU solve of the expanded matrix
+  double A[N * N], LU[N * N], perm[N], sign;
+  SymMatToMatCore<double, N>(get_data(S), A);
+  MatLUFactorCore<double, N>(A, LU, perm, sign);
+  MatLUSolveCore<double, N>(LU, perm, b, y);
+  SymMatCholSolveCore<double, N>(get_data(L), b, x);
+
+  for (int i = 0; i < N; i++) {
+    EXPECT_NEAR(x[i], y[i], 1e-14);
+  }
+
+  // The solve may be computed in place
+  SymMatCholSolveCore<double, N>(get_data(L), b, b);
+  for (int i = 0; i < N; i++) {
+    EXPECT_DOUBLE_EQ(x[i], b[i]);
+  }
+}
+
+TEST(test_a2dsymcholcore, Factor) {
+  test_factor<1>();
+  test_factor<2>();
+  test_factor<3>();
+  test_factor<4>();
+  test_factor<6>();
+}
+
+TEST(test_a2dsymcholcore, Solve) {
+  test_solve<1>();
+  test_solve<3>();
+  test_solve<5>();
+  test_solve<6>();
+}
@@ -0,0 +1,513 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "a2dcore.h"
+#include "ad/a2dassembly.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+// Connectivity of a structured mesh of nx x ny x nz hexahedral elements
+std::vector<index_t> make_hex_mesh(index_t nx, index_t ny, index_t nz) {
+  std::vector<index_t> conn;
+  auto node = [&](index_t i, index_t j, index_t k) {
+    return i + (nx + 1) * (j + (ny + 1) * k);
+  };
+  for (index_t k = 0; k < nz; k++) {
+    for (index_t j = 0; j < ny; j++) {
+      for (index_t i = 0; i < nx; i++) {
+        index_t nodes[8] = {node(i, j, k),         node(i + 1, j, k),
+                            node(i + 1, j + 1, k), node(i, j + 1, k),
+                            node(i, j, k + 1),     node(i + 1, j, k + 1),
+                            node(i + 1, j + 1, k + 1),
+                            node(i, j + 1, k + 1)};
+        conn.insert(conn.end(), nodes, nodes + 8);
+      }
+    }
+  }
+  return conn;
+}
+
+// Strain energy of an element with the displacement gradient Ux = u^T dN
+template <typename T>
+auto make_energy_plan(const Mat<T, 8, 3>& dN) {
+  return MakeStackPlan<A2DObj<Mat<T, 8, 3>>, A2DObj<Mat<T, 3, 3>>,
+                       A2DObj<SymMat<T, 3>>, A2DObj<SymMat<T, 3>>, A2DObj<T>>(
+      [&dN](auto& u, auto& Ux, auto& E, auto& S, auto& energy) {
+        return MakeStack(
+            uninit, MatMatMult<MatOp::TRANSPOSE, MatOp::NORMAL>(u, dN, Ux),
+            MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+            SymIsotropic(T(0.35), T(0.51), E, S),
+            SymMatMultTrace(E, S, energy));
+      });
+}
+
+// Compute the element residual and Jacobian with the plan for the element
+// displacements in u
+template <class Plan, class ElemVec, class ElemMat>
+void energy_kernel(Plan& plan, ElemVec& re, ElemMat& ke) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  u.bvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  plan.get_stack().hextract(u.pvalue(), u.hvalue(), ke);  // Calls reverse()
+  for (int i = 0; i < 24; i++) {
+    re[i] = u.bvalue()[i];
+  }
+}
+
+// Copy a BSR matrix into a dense row-major matrix
+template <typename T, index_t M>
+std::vector<T> to_dense(const BSRMat<T, M>& A) {
+  const index_t n = A.get_num_rows();
+  std::vector<T> dense(n * n, 0.0);
+  for (index_t i = 0; i < A.get_num_block_rows(); i++) {
+    for (index_t k = A.rowp[i]; k < A.rowp[i + 1]; k++) {
+      for (index_t ii = 0; ii < M; ii++) {
+        for (index_t jj = 0; jj < M; jj++) {
+          dense[n * (M * i + ii) + M * A.cols[k] + jj] =
+              A.get_block(k)[M * ii + jj];
+        }
+      }
+    }
+  }
+  return dense;
+}
+
+TEST(test_a2dassembly, ThreadPool) {
+  for (index_t nthreads : {1, 2, 5}) {
+    ThreadPool pool(nthreads);
+    EXPECT_EQ(pool.get_num_threads(), nthreads);
+
+    // Each thread writes its own entry, then reads all of them after the
+    // barrier
+    for (int iter = 0; iter < 3; iter++) {
+      std::vector<index_t> ids(nthreads, -1);
+      std::atomic<int> count(0);
+      pool.run([&](index_t id) {
+        ids[id] = id;
+        pool.barrier();
+        for (index_t i = 0; i < nthreads; i++) {
+          if (ids[i] == i) {
+            count++;
+          }
+        }
+      });
+      EXPECT_EQ(count, nthreads * nthreads);
+    }
+  }
+}
+
+// Every item must be visited once, with uneven costs that force steals
+TEST(test_a2dassembly, WorkStealingScheduler) {
+  const index_t n = 1003;
+  for (index_t nthreads : {1, 3, 4}) {
+    ThreadPool pool(nthreads);
+    WorkStealingScheduler scheduler(pool, 5);
+
+    for (int iter = 0; iter < 2; iter++) {
+      std::vector<std::atomic<int>> visited(n);
+      for (auto& v : visited) {
+        v = 0;
+      }
+      scheduler.parallel_for(n, [&](index_t id, index_t i) {
+        // The first items are much more expensive than the others
+        if (i < n / 4) {
+          std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        visited[i]++;
+      });
+      for (index_t i = 0; i < n; i++) {
+        EXPECT_EQ(visited[i], 1);
+      }
+    }
+
+    const std::vector<WorkerStats>& stats = scheduler.get_stats();
+    EXPECT_EQ(stats.size(), nthreads);
+    index_t num_items = 0, num_chunks = 0;
+    for (const WorkerStats& s : stats) {
+      num_items += s.num_items;
+      num_chunks += s.num_chunks;
+      EXPECT_GE(s.busy_time, 0.0);
+      EXPECT_GE(s.idle_time, 0.0);
+    }
+    EXPECT_EQ(num_items, 2 * n);
+    EXPECT_EQ(num_chunks, 2 * ((n + 4) / 5));
+
+    scheduler.reset_stats();
+    EXPECT_EQ(scheduler.get_stats()[0].num_items, 0);
+  }
+}
+
+TEST(test_a2dassembly, ElementColoring) {
+  const index_t nx = 4, ny = 3, nz = 2, nelems = nx * ny * nz;
+  std::vector<index_t> conn = make_hex_mesh(nx, ny, nz);
+  ElementColoring coloring(nelems, 8, conn.data());
+
+  // Neighboring elements of a structured hexahedral mesh need 8 colors
+  EXPECT_EQ(coloring.get_num_colors(), 8);
+
+  std::vector<int> visited(nelems, 0);
+  for (index_t c = 0; c < coloring.get_num_colors(); c++) {
+    const index_t* elems;
+    index_t size = coloring.get_elements(c, &elems);
+    std::vector<int> node_used((nx + 1) * (ny + 1) * (nz + 1), 0);
+    for (index_t i = 0; i < size; i++) {
+      visited[elems[i]]++;
+      for (index_t j = 0; j < 8; j++) {
+        EXPECT_EQ(node_used[conn[8 * elems[i] + j]]++, 0);
+      }
+    }
+  }
+  for (index_t e = 0; e < nelems; e++) {
+    EXPECT_EQ(visited[e], 1);
+  }
+}
+
+// The element Jacobian of the kernel must match central differences of the
+// element residual, so that the assembly tests do not only compare the kernel
+// with itself
+TEST(test_a2dassembly, ElementJacobian) {
+  using T = double;
+  Mat<T, 8, 3> dN, u0;
+  for (int i = 0; i < 24; i++) {
+    dN[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+    u0[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+  }
+
+  auto plan = make_energy_plan<T>(dN);
+  auto& u = plan.template get<0>();
+  Vec<T, 24> re;
+  Mat<T, 24, 24> ke;
+  u.value().copy(u0);
+  energy_kernel(plan, re, ke);
+
+  const T dh = 1e-6;
+  for (int j = 0; j < 24; j++) {
+    Vec<T, 24> rp, rm;
+    Mat<T, 24, 24> kp;
+    u.value().copy(u0);
+    u.value()[j] += dh;
+    energy_kernel(plan, rp, kp);
+    u.value().copy(u0);
+    u.value()[j] -= dh;
+    energy_kernel(plan, rm, kp);
+    for (int i = 0; i < 24; i++) {
+      EXPECT_NEAR(ke(i, j), (rp[i] - rm[i]) / (2.0 * dh), 1e-6);
+    }
+  }
+}
+
+TEST(test_a2dassembly, BSRMat) {
+  using T = double;
+  const index_t nx = 3, ny = 2, nz = 2, nelems = nx * ny * nz;
+  std::vector<index_t> conn = make_hex_mesh(nx, ny, nz);
+  BSRMat<T, 3> A(nelems, 8, conn.data());
+
+  // Each node is coupled to the nodes of the 3 x 3 x 3 patch around it that
+  // are in the mesh
+  const index_t nnodes = (nx + 1) * (ny + 1) * (nz + 1);
+  EXPECT_EQ(A.get_num_block_rows(), nnodes);
+  index_t nblocks = 0;
+  for (index_t k = 0; k <= nz; k++) {
+    for (index_t j = 0; j <= ny; j++) {
+      for (index_t i = 0; i <= nx; i++) {
+        nblocks += (1 + (i > 0) + (i < nx)) * (1 + (j > 0) + (j < ny)) *
+                   (1 + (k > 0) + (k < nz));
+      }
+    }
+  }
+  EXPECT_EQ(A.get_num_blocks(), nblocks);
+  EXPECT_EQ(A.find_block(0, nnodes - 1), NO_INDEX);
+
+  // Add random element matrices, full and symmetric, to the BSR matrix with
+  // and without atomics and to a dense matrix
+  const index_t n = 3 * nnodes;
+  std::vector<T> dense(n * n, 0.0);
+  BSRMat<T, 3> B(nelems, 8, conn.data());
+  for (index_t e = 0; e < nelems; e++) {
+    Mat<T, 24, 24> ke;
+    SymMat<T, 24> kes;
+    for (int i = 0; i < 24 * 24; i++) {
+      ke[i] = static_cast<T>(rand()) / RAND_MAX;
+    }
+    for (int i = 0; i < kes.ncomp; i++) {
+      kes[i] = static_cast<T>(rand()) / RAND_MAX;
+    }
+    A.add_element(e, ke);
+    A.add_element(e, kes);
+    B.add_element_atomic(e, ke);
+    B.add_element_atomic(e, kes);
+    for (int i = 0; i < 24; i++) {
+      index_t row = 3 * conn[8 * e + i / 3] + i % 3;
+      for (int j = 0; j < 24; j++) {
+        index_t col = 3 * conn[8 * e + j / 3] + j % 3;
+        dense[n * row + col] += ke(i, j) + kes(i, j);
+      }
+    }
+  }
+
+  std::vector<T> Ad = to_dense(A), Bd = to_dense(B);
+  for (index_t i = 0; i < n * n; i++) {
+    EXPECT_NEAR(Ad[i], dense[i], 1e-13);
+    EXPECT_NEAR(Bd[i], dense[i], 1e-13);
+  }
+
+  std::vector<T> x(n), y(n);
+  for (index_t i = 0; i < n; i++) {
+    x[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  A.mult(x.data(), y.data());
+  for (index_t i = 0; i < n; i++) {
+    T yi = 0.0;
+    for (index_t j = 0; j < n; j++) {
+      yi += dense[n * i + j] * x[j];
+    }
+    EXPECT_NEAR(y[i], yi, 1e-12);
+  }
+
+  A.zero();
+  for (T v : A.vals) {
+    EXPECT_EQ(v, 0.0);
+  }
+
+#ifndef NDEBUG
+  // The element matrix of an element with another number of nodes
+  Mat<T, 12, 12> ke4;
+  EXPECT_DEATH(A.add_element(0, ke4), "nodes per element");
+#endif
+}
+
+// The residual and Jacobian assembled in parallel must match a serial loop
+// over the elements
+TEST(test_a2dassembly, ElementAssembler) {
+  using T = double;
+  const index_t nx = 3, ny = 3, nz = 2, nelems = nx * ny * nz;
+  std::vector<index_t> conn = make_hex_mesh(nx, ny, nz);
+
+  Mat<T, 8, 3> dN;
+  for (int i = 0; i < 24; i++) {
+    dN[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+  }
+
+  const index_t nnodes = (nx + 1) * (ny + 1) * (nz + 1), n = 3 * nnodes;
+  std::vector<T> x(n);
+  for (index_t i = 0; i < n; i++) {
+    x[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+  }
+
+  // Serial reference
+  std::vector<T> res0(n, 0.0), jac0(n * n, 0.0);
+  for (index_t e = 0; e < nelems; e++) {
+    auto plan = make_energy_plan<T>(dN);
+    for (int j = 0; j < 8; j++) {
+      for (int k = 0; k < 3; k++) {
+        plan.template get<0>().value()(j, k) = x[3 * conn[8 * e + j] + k];
+      }
+    }
+    Vec<T, 24> re;
+    Mat<T, 24, 24> ke;
+    energy_kernel(plan, re, ke);
+    for (int i = 0; i < 24; i++) {
+      index_t row = 3 * conn[8 * e + i / 3] + i % 3;
+      res0[row] += re[i];
+      for (int j = 0; j < 24; j++) {
+        index_t col = 3 * conn[8 * e + j / 3] + j % 3;
+        jac0[n * row + col] += ke(i, j);
+      }
+    }
+  }
+
+  for (index_t nthreads : {1, 2, 5}) {
+    ThreadPool pool(nthreads);
+    ElementAssembler<T, 8, 3> assembler(nelems, conn.data(), pool);
+    EXPECT_EQ(assembler.get_num_dof(), n);
+
+    auto make_local = [&]() { return make_energy_plan<T>(dN); };
+    auto kernel = [&](auto& plan, index_t elem, auto& re, auto&... ke) {
+      assembler.gather(elem, x.data(), plan.template get<0>().value());
+      Mat<T, 24, 24> ke0;
+      energy_kernel(plan, re, ke0);
+      ((ke = ke0), ...);
+    };
+
+    std::vector<T> res(n, 0.0), jac(n * n, 0.0);
+    assembler.add_jacobian(make_local, kernel, res.data(), jac.data());
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(res[i], res0[i], 1e-12);
+    }
+    for (index_t i = 0; i < n * n; i++) {
+      EXPECT_NEAR(jac[i], jac0[i], 1e-12);
+    }
+
+    std::vector<T> res1(n, 0.0);
+    assembler.add_residual(make_local, kernel, res1.data());
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(res1[i], res0[i], 1e-12);
+    }
+
+    // Distribute the elements by work stealing
+    WorkStealingScheduler scheduler(pool, 2);
+    assembler.set_scheduler(&scheduler);
+    std::vector<T> res2(n, 0.0), jac2(n * n, 0.0);
+    assembler.add_jacobian(make_local, kernel, res2.data(), jac2.data());
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(res2[i], res0[i], 1e-12);
+    }
+    for (index_t i = 0; i < n * n; i++) {
+      EXPECT_NEAR(jac2[i], jac0[i], 1e-12);
+    }
+
+    index_t num_items = 0;
+    for (const WorkerStats& s : scheduler.get_stats()) {
+      num_items += s.num_items;
+    }
+    EXPECT_EQ(num_items, nelems);
+
+    // Split the columns of each element Jacobian between the threads
+    auto column_kernel = [&](auto& plan, index_t elem, auto& re, auto& ke,
+                             index_t begin, index_t end) {
+      auto& u = plan.template get<0>();
+      assembler.gather(elem, x.data(), u.value());
+      plan.eval();
+      plan.get_stack().bzero();
+      u.bvalue().zero();
+      plan.template get<4>().bvalue() = 1.0;
+      plan.get_stack().hextract_range(u.pvalue(), u.hvalue(), ke, begin, end);
+      for (int i = 0; i < 24; i++) {
+        re[i] = u.bvalue()[i];
+      }
+    };
+    std::vector<T> res3(n, 0.0), jac3(n * n, 0.0);
+    assembler.add_jacobian_by_columns(make_local, column_kernel, res3.data(),
+                                      jac3.data());
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(res3[i], res0[i], 1e-12);
+    }
+    for (index_t i = 0; i < n * n; i++) {
+      EXPECT_NEAR(jac3[i], jac0[i], 1e-12);
+    }
+
+    // Assemble into BSR matrices, by color and with atomic additions
+    for (bool atomic : {false, true}) {
+      BSRMat<T, 3> bsr(nelems, 8, conn.data());
+      std::vector<T> res4(n, 0.0);
+      if (atomic) {
+        assembler.add_jacobian_atomic(make_local, kernel, res4.data(), bsr);
+      } else {
+        assembler.add_jacobian(make_local, kernel, res4.data(), bsr);
+      }
+      std::vector<T> jac4 = to_dense(bsr);
+      for (index_t i = 0; i < n; i++) {
+        EXPECT_NEAR(res4[i], res0[i], 1e-12);
+      }
+      for (index_t i = 0; i < n * n; i++) {
+        EXPECT_NEAR(jac4[i], jac0[i], 1e-12);
+      }
+    }
+  }
+}
+
+// Compute the products of K element Jacobians with the directions in the
+// lanes of pe, for the element displacements in the lanes of u
+template <class Plan, class ElemVec>
+void energy_product_kernel(Plan& plan, const ElemVec& pe, ElemVec& ye) {
+  auto& u = plan.template get<0>();
+  plan.eval();
+  plan.get_stack().bzero();
+  plan.get_stack().hzero();
+  u.bvalue().zero();
+  u.hvalue().zero();
+  plan.template get<4>().bvalue() = 1.0;
+  for (int i = 0; i < 24; i++) {
+    u.pvalue()[i] = pe[i];
+  }
+  plan.get_stack().hproduct();
+  for (int i = 0; i < 24; i++) {
+    ye[i] = u.hvalue()[i];
+  }
+}
+
+// Product with any operator with a const mult(), as in a Krylov solver
+template <class Operator, typename T>
+void apply_operator(const Operator& A, const std::vector<T>& x,
+                    std::vector<T>& y) {
+  A.mult(x.data(), y.data());
+}
+
+// The matrix-free products must match the products with the assembled
+// Jacobian, also when the last batch of a color is not full
+template <index_t K>
+void test_matrix_free_jacobian() {
+  using T = double;
+  using Tb = simd<T, K>;
+  const index_t nx = 3, ny = 3, nz = 2, nelems = nx * ny * nz;
+  std::vector<index_t> conn = make_hex_mesh(nx, ny, nz);
+
+  Mat<T, 8, 3> dN;
+  Mat<Tb, 8, 3> dNb;
+  for (int i = 0; i < 24; i++) {
+    dN[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+    dNb[i] = dN[i];
+  }
+
+  const index_t nnodes = (nx + 1) * (ny + 1) * (nz + 1), n = 3 * nnodes;
+  std::vector<T> x(n), p(n);
+  for (index_t i = 0; i < n; i++) {
+    x[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+    p[i] = static_cast<T>(rand()) / RAND_MAX - 0.5;
+  }
+
+  for (index_t nthreads : {1, 3}) {
+    ThreadPool pool(nthreads);
+    ElementAssembler<T, 8, 3> assembler(nelems, conn.data(), pool);
+
+    // Reference product with the assembled Jacobian
+    auto kernel = [&](auto& plan, index_t elem, auto& re, auto& ke) {
+      assembler.gather(elem, x.data(), plan.template get<0>().value());
+      energy_kernel(plan, re, ke);
+    };
+    BSRMat<T, 3> bsr(nelems, 8, conn.data());
+    std::vector<T> res(n, 0.0), y0(n);
+    assembler.add_jacobian([&]() { return make_energy_plan<T>(dN); }, kernel,
+                           res.data(), bsr);
+    apply_operator(bsr, p, y0);
+
+    auto product_kernel = [&](auto& plan, const index_t* elems, index_t count,
+                              auto& pe, auto& ye) {
+      assembler.gather_lanes(elems, count, x.data(),
+                             plan.template get<0>().value());
+      energy_product_kernel(plan, pe, ye);
+    };
+    auto jac = MakeMatrixFreeJacobian<K>(
+        assembler, [&]() { return make_energy_plan<Tb>(dNb); },
+        product_kernel);
+    EXPECT_EQ(jac.get_num_rows(), n);
+
+    // The output is overwritten
+    std::vector<T> y(n, 1.0);
+    jac.mult(p.data(), y.data());
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(y[i], y0[i], 1e-12);
+    }
+
+    // Distribute the batches by work stealing
+    WorkStealingScheduler scheduler(pool, 1);
+    assembler.set_scheduler(&scheduler);
+    std::vector<T> y1(n, 0.0);
+    apply_operator(jac, p, y1);
+    for (index_t i = 0; i < n; i++) {
+      EXPECT_NEAR(y1[i], y0[i], 1e-12);
+    }
+  }
+}
+
+TEST(test_a2dassembly, MatrixFreeJacobian) {
+  test_matrix_free_jacobian<1>();
+  test_matrix_free_jacobian<4>();
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "a2dcore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+template <typename T>
+T random_value() {
+  return static_cast<T>(rand()) / RAND_MAX;
+}
+
+TEST(test_a2dbatch, LaneLayout) {
+  constexpr int W = 4;
+  MatBatch<double, 2, 3, W> A;
+  Mat<double, 2, 3> B[W];
+
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < 6; i++) {
+      B[w][i] = 10.0 * w + i;
+    }
+  }
+  BatchGather(W, B, A);
+
+  // Entry k of lane w is stored at offset k * W + w
+  const double* data = reinterpret_cast<const double*>(A.get_data());
+  for (int w = 0; w < W; w++) {
+    for (int k = 0; k < 6; k++) {
+      EXPECT_DOUBLE_EQ(data[k * W + w], B[w][k]);
+    }
+  }
+
+  Mat<double, 2, 3> C;
+  for (int w = 0; w < W; w++) {
+    BatchGetLane(A, w, C);
+    EXPECT_MAT_NEAR(2, 3, C, B[w]);
+  }
+}
+
+TEST(test_a2dbatch, MatMatMult) {
+  constexpr int W = 4;
+  MatBatch<double, 3, 4, W> A;
+  MatBatch<double, 4, 2, W> B;
+  MatBatch<double, 3, 2, W> C;
+
+  Mat<double, 3, 4> As[W];
+  Mat<double, 4, 2> Bs[W];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < 12; i++) {
+      As[w][i] = random_value<double>();
+    }
+    for (int i = 0; i < 8; i++) {
+      Bs[w][i] = random_value<double>();
+    }
+  }
+  BatchGather(W, As, A);
+  BatchGather(W, Bs, B);
+
+  MatMatMult(A, B, C);
+
+  for (int w = 0; w < W; w++) {
+    Mat<double, 3, 2> Cs, Cw;
+    MatMatMult(As[w], Bs[w], Cs);
+    BatchGetLane(C, w, Cw);
+    EXPECT_MAT_NEAR(3, 2, Cw, Cs, 1e-15);
+  }
+}
+
+// Evaluate the strain energy stack on a batch and compare each lane with the
+// scalar evaluation
+TEST(test_a2dbatch, StrainEnergyStack) {
+  constexpr int N = 3;
+  constexpr int W = 4;
+  using T = double;
+  using Tb = simd<T, W>;
+  constexpr GreenStrainType etype = GreenStrainType::NONLINEAR;
+  const T mu = 0.35, lambda = 1.23;
+
+  A2DObj<Mat<Tb, N, N>> Ux;
+  A2DObj<SymMat<Tb, N>> E, S;
+  A2DObj<Tb> energy;
+
+  Mat<T, N, N> Uxs[W], Pxs[W];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < N * N; i++) {
+      Uxs[w][i] = random_value<T>();
+      Pxs[w][i] = random_value<T>();
+    }
+  }
+  BatchGather(W, Uxs, Ux.value());
+  BatchGather(W, Pxs, Ux.pvalue());
+
+  auto stack = MakeStack(MatGreenStrain<etype>(Ux, E),
+                         SymIsotropic(mu, lambda, E, S),
+                         SymMatMultTrace(E, S, energy));
+
+  energy.bvalue() = 1.0;
+  stack.hproduct();
+  Mat<Tb, N, N> Uxb(Ux.bvalue()), Uxh(Ux.hvalue());
+
+  // Extract the Hessian of the batch
+  Mat<Tb, N * N, N * N> jac;
+  stack.bzero();
+  Ux.bvalue().zero();
+  energy.bvalue() = 1.0;
+  stack.hextract(Ux.pvalue(), Ux.hvalue(), jac);
+
+  for (int w = 0; w < W; w++) {
+    A2DObj<Mat<T, N, N>> Uxw(Uxs[w]);
+    A2DObj<SymMat<T, N>> Ew, Sw;
+    A2DObj<T> energyw;
+    Uxw.pvalue().copy(Pxs[w]);
+
+    auto stackw = MakeStack(MatGreenStrain<etype>(Uxw, Ew),
+                            SymIsotropic(mu, lambda, Ew, Sw),
+                            SymMatMultTrace(Ew, Sw, energyw));
+    energyw.bvalue() = 1.0;
+    stackw.hproduct();
+
+    EXPECT_NEAR(energy.value()[w], energyw.value(), 1e-14);
+    for (int i = 0; i < N * N; i++) {
+      EXPECT_NEAR(Uxb[i][w], Uxw.bvalue()[i], 1e-13);
+      EXPECT_NEAR(Uxh[i][w], Uxw.hvalue()[i], 1e-13);
+    }
+
+    // The Hessian-vector product from the extracted Hessian
+    for (int i = 0; i < N * N; i++) {
+      T value = 0.0;
+      for (int j = 0; j < N * N; j++) {
+        value += jac(i, j)[w] * Pxs[w][j];
+      }
+      EXPECT_NEAR(value, Uxw.hvalue()[i], 1e-12);
+    }
+  }
+}
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <complex>
+#include <cstdint>
+#include <vector>
 
+#include "ad/a2dgemm.h"
 #include "ad/a2dmat.h"
+#include "ad/a2dvec.h"
 #include "test_commons.h"
 
 using namespace A2D;
@@ -90,3 +94,61 @@ TEST(test_a2dmat, SymMat_const_operator) {
     }
   }
 }
+
+// The storage honors the alignment policy, and the object size is padded so
+// that objects in an array stay aligned
+template <class Obj>
+void check_alignment() {
+  Obj objs[3];
+  EXPECT_EQ(sizeof(Obj) % Obj::align, 0u);
+  for (int i = 0; i < 3; i++) {
+    auto addr = reinterpret_cast<std::uintptr_t>(objs[i].get_data());
+    EXPECT_EQ(addr % Obj::align, 0u);
+  }
+}
+
+TEST(test_a2dmat, Alignment) {
+  check_alignment<Mat<double, 3, 3>>();
+  check_alignment<Mat<float, 2, 3>>();
+  check_alignment<SymMat<double, 3>>();
+  check_alignment<SymMat<double, 6>>();
+  check_alignment<Vec<double, 3>>();
+  EXPECT_GE((Mat<double, 3, 3>::align), std::size_t(A2D_ALIGN));
+  EXPECT_GE((SymMat<double, 3>::align), alignof(double));
+
+#if A2D_ALIGN > 0
+  // Built by test_a2dmat_align: every object starts on an A2D_ALIGN boundary
+  // and its size is padded, also for heap arrays
+  EXPECT_EQ(storage_alignment<double>::value, std::size_t(A2D_ALIGN));
+  EXPECT_EQ((Mat<double, 3, 3>::align), std::size_t(A2D_ALIGN));
+  EXPECT_EQ((sizeof(Vec<double, 3>)), std::size_t(A2D_ALIGN));
+  std::vector<SymMat<double, 3>> heap(5);
+  for (const auto& S : heap) {
+    auto addr = reinterpret_cast<std::uintptr_t>(S.get_data());
+    EXPECT_EQ(addr % A2D_ALIGN, 0u);
+  }
+#endif
+}
+
+// The core kernels read and write through the aligned get_data() pointers
+TEST(test_a2dmat, AlignedKernels) {
+  Mat<double, 3, 4> A;
+  Mat<double, 4, 5> B;
+  Mat<double, 3, 5> C;
+  for (int i = 0; i < A.ncomp; i++) {
+    A[i] = 0.5 * i - 1.0;
+  }
+  for (int i = 0; i < B.ncomp; i++) {
+    B[i] = 1.0 - 0.25 * i;
+  }
+  MatMatMult(A, B, C);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) {
+      double value = 0.0;
+      for (int k = 0; k < 4; k++) {
+        value += A(i, k) * B(k, j);
+      }
+      EXPECT_DOUBLE_EQ(C(i, j), value);
+    }
+  }
+}
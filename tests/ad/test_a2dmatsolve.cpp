@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "a2ddefs.h"
+#include "ad/a2dgemm.h"
+#include "ad/a2dmat.h"
+#include "ad/a2dmatinv.h"
+#include "ad/a2dmatsolve.h"
+#include "ad/a2dmatvecmult.h"
+#include "ad/a2dstack.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+// Compare x = A^{-1} b and its adjoints against MatInv followed by MatVecMult
+template <typename T, int N>
+void test_mat_solve() {
+  A2DObj<Mat<T, N, N>> A, Ainv;
+  A2DObj<Vec<T, N>> b, x, y;
+  A2DObj<Mat<T, N, N>> A0;
+  A2DObj<Vec<T, N>> b0;
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      A.value()(i, j) = static_cast<T>(rand()) / RAND_MAX;
+      A.pvalue()(i, j) = static_cast<T>(rand()) / RAND_MAX;
+    }
+    A.value()(i, i) += N;
+    b.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    b.pvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  A0.value() = A.value();
+  A0.pvalue() = A.pvalue();
+  b0.value() = b.value();
+  b0.pvalue() = b.pvalue();
+
+  auto stack = MakeStack(MatSolve(A, b, x));
+  auto stack0 = MakeStack(MatInv(A0, Ainv), MatVecMult(Ainv, b0, y));
+
+  for (int i = 0; i < N; i++) {
+    x.bvalue()[i] = y.bvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+    x.hvalue()[i] = y.hvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  stack.hproduct();
+  stack0.hproduct();
+
+  for (int i = 0; i < N; i++) {
+    EXPECT_NEAR(x.value()[i], y.value()[i], 1e-13);
+    EXPECT_NEAR(x.pvalue()[i], y.pvalue()[i], 1e-13);
+    EXPECT_NEAR(b.bvalue()[i], b0.bvalue()[i], 1e-13);
+    EXPECT_NEAR(b.hvalue()[i], b0.hvalue()[i], 1e-13);
+    for (int j = 0; j < N; j++) {
+      EXPECT_NEAR(A.bvalue()(i, j), A0.bvalue()(i, j), 1e-13);
+      EXPECT_NEAR(A.hvalue()(i, j), A0.hvalue()(i, j), 1e-13);
+    }
+  }
+}
+
+// A symmetric matrix must give the same solution as its full expansion
+template <typename T, int N>
+void test_sym_mat_solve() {
+  SymMat<T, N> S;
+  Mat<T, N, N> A;
+  Vec<T, N> b, x, xs;
+
+  for (int i = 0; i < S.ncomp; i++) {
+    S[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      A(i, j) = S(i, j);
+    }
+    b[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  MatSolve(A, b, x);
+  MatSolve(S, b, xs);
+
+  for (int i = 0; i < N; i++) {
+    EXPECT_DOUBLE_EQ(x[i], xs[i]);
+  }
+}
+
+// Only the right-hand side is active
+template <typename T, int N>
+void test_mat_solve_passive_matrix() {
+  Mat<T, N, N> A;
+  ADObj<Vec<T, N>> b, x;
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      A(i, j) = static_cast<T>(rand()) / RAND_MAX;
+    }
+    A(i, i) += N;
+    b.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    x.bvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  auto stack = MakeStack(MatSolve(A, b, x));
+  stack.reverse();
+
+  // b.bvalue() = A^{-T} * x.bvalue()
+  Vec<T, N> r;
+  MatVecMult<MatOp::TRANSPOSE>(A, b.bvalue(), r);
+  for (int i = 0; i < N; i++) {
+    EXPECT_NEAR(r[i], x.bvalue()[i], 1e-13);
+  }
+}
+
+TEST(test_a2dmatsolve, MatSolve) {
+  test_mat_solve<double, 1>();
+  test_mat_solve<double, 3>();
+  test_mat_solve<double, 4>();
+  test_mat_solve<double, 6>();
+}
+
+TEST(test_a2dmatsolve, SymMatSolve) {
+  test_sym_mat_solve<double, 2>();
+  test_sym_mat_solve<double, 3>();
+  test_sym_mat_solve<double, 5>();
+}
+
+TEST(test_a2dmatsolve, PassiveMatrix) {
+  test_mat_solve_passive_matrix<double, 3>();
+  test_mat_solve_passive_matrix<double, 5>();
+}
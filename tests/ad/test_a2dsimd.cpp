@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include "a2dcore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+constexpr int W = 4;
+using Tb = simd<double, W>;
+
+double random_value() { return static_cast<double>(rand()) / RAND_MAX; }
+
+TEST(test_a2dsimd, Traits) {
+  EXPECT_TRUE(is_scalar_type<Tb>::value);
+  EXPECT_TRUE(is_numeric_type<Tb>::value);
+  EXPECT_TRUE((std::is_same<get_object_numeric_type<Tb>::type, Tb>::value));
+  EXPECT_TRUE(get_a2d_object_type<Tb>::value == ADObjType::SCALAR);
+  EXPECT_TRUE(
+      (std::is_same<get_object_numeric_type<ADObj<Mat<Tb, 3, 3>>>::type,
+                    Tb>::value));
+}
+
+TEST(test_a2dsimd, MaxMin) {
+  Tb a, b;
+  for (int w = 0; w < W; w++) {
+    a[w] = random_value() - 0.5;
+    b[w] = random_value() - 0.5;
+  }
+  Tb mx = max2(a, b), mn = min2(a, b);
+  for (int w = 0; w < W; w++) {
+    EXPECT_DOUBLE_EQ(mx[w], max2(a[w], b[w]));
+    EXPECT_DOUBLE_EQ(mn[w], min2(a[w], b[w]));
+  }
+}
+
+TEST(test_a2dsimd, SymEigs2x2) {
+  // Lanes with positive, negative and zero trace and a diagonal matrix
+  const double vals[W][3] = {{1.0, 0.3, 2.0},
+                             {-1.5, 0.7, -0.25},
+                             {0.5, -0.2, -0.5},
+                             {-2.0, 0.0, 1.0}};
+  Tb A[3], eigs[2], Q[4];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < 3; i++) {
+      A[i][w] = vals[w][i];
+    }
+  }
+  SymEigs2x2(A, eigs, Q);
+
+  for (int w = 0; w < W; w++) {
+    double e[2], q[4];
+    SymEigs2x2(vals[w], e, q);
+    for (int i = 0; i < 2; i++) {
+      EXPECT_DOUBLE_EQ(eigs[i][w], e[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+      EXPECT_DOUBLE_EQ(Q[i][w], q[i]);
+    }
+  }
+}
+
+TEST(test_a2dsimd, SymEigs3x3) {
+  // Lanes with distinct eigenvalues, a double root, a triple root and a
+  // diagonal matrix
+  const double vals[W][6] = {{0.3, -0.2, 0.1, 0.4, 0.25, -0.6},
+                             {2.0, 1.0, 2.0, 1.0, 1.0, 2.0},
+                             {1.5, 0.0, 1.5, 0.0, 0.0, 1.5},
+                             {-1.0, 0.0, 3.0, 0.0, 0.0, 0.5}};
+  Tb A[6], eigs[3], Q[9];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < 6; i++) {
+      A[i][w] = vals[w][i];
+    }
+  }
+  SymEigs3x3(A, eigs, Q);
+
+  for (int w = 0; w < W; w++) {
+    double e[3], q[9];
+    SymEigs3x3(vals[w], e, q);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_DOUBLE_EQ(eigs[i][w], e[i]);
+    }
+    for (int i = 0; i < 9; i++) {
+      EXPECT_DOUBLE_EQ(Q[i][w], q[i]);
+    }
+  }
+}
+
+TEST(test_a2dsimd, SymMatTriReduce) {
+  constexpr int N = 5;
+  constexpr int size = N * (N + 1) / 2;
+  double As[W][size];
+  Tb A[size], alpha[N], beta[N], work[N], P[N * N];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < size; i++) {
+      As[w][i] = random_value() - 0.5;
+      A[i][w] = As[w][i];
+    }
+  }
+  for (int i = 0; i < N * N; i++) {
+    P[i] = (i % (N + 1) == 0 ? 1.0 : 0.0);
+  }
+  SymMatTriReduce<Tb, N>(A, alpha, beta, work, P);
+
+  for (int w = 0; w < W; w++) {
+    double a[N], b[N], wk[N], p[N * N];
+    for (int i = 0; i < N * N; i++) {
+      p[i] = (i % (N + 1) == 0 ? 1.0 : 0.0);
+    }
+    SymMatTriReduce<double, N>(As[w], a, b, wk, p);
+    for (int i = 0; i < N; i++) {
+      EXPECT_NEAR(alpha[i][w], a[i], 1e-14);
+    }
+    for (int i = 0; i < N - 1; i++) {
+      EXPECT_NEAR(beta[i][w], b[i], 1e-14);
+    }
+    for (int i = 0; i < N * N; i++) {
+      EXPECT_NEAR(P[i][w], p[i], 1e-14);
+    }
+  }
+}
+
+// Instantiate the matrix inverse, determinant and constitutive expressions on
+// the lane type and compare each lane against the scalar result
+TEST(test_a2dsimd, MatInvDetIsotropic) {
+  constexpr int N = 3;
+  using T = double;
+  Mat<T, N, N> Js[W];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < N * N; i++) {
+      Js[w][i] = random_value() + (i % (N + 1) == 0 ? 1.0 : 0.0);
+    }
+  }
+
+  ADObj<Mat<Tb, N, N>> J, Jinv;
+  ADObj<SymMat<Tb, N>> E, S;
+  ADObj<Tb> detJ, energy;
+  BatchGather(W, Js, J.value());
+
+  auto stack = MakeStack(MatInv(J, Jinv), MatDet(J, detJ),
+                         SymMatRK<MatOp::TRANSPOSE>(Jinv, E),
+                         SymIsotropic(T(0.35), T(0.51), E, S),
+                         SymMatMultTrace(E, S, energy));
+  energy.bvalue() = 1.0;
+  detJ.bvalue() = 1.0;
+  stack.reverse();
+
+  for (int w = 0; w < W; w++) {
+    ADObj<Mat<T, N, N>> Jw(Js[w]), Jinvw;
+    ADObj<SymMat<T, N>> Ew, Sw;
+    ADObj<T> detJw, energyw;
+    auto stackw = MakeStack(MatInv(Jw, Jinvw), MatDet(Jw, detJw),
+                            SymMatRK<MatOp::TRANSPOSE>(Jinvw, Ew),
+                            SymIsotropic(T(0.35), T(0.51), Ew, Sw),
+                            SymMatMultTrace(Ew, Sw, energyw));
+    energyw.bvalue() = 1.0;
+    detJw.bvalue() = 1.0;
+    stackw.reverse();
+
+    EXPECT_NEAR(detJ.value()[w], detJw.value(), 1e-14);
+    EXPECT_NEAR(energy.value()[w], energyw.value(), 1e-13);
+    for (int i = 0; i < N * N; i++) {
+      EXPECT_NEAR(Jinv.value()[i][w], Jinvw.value()[i], 1e-14);
+      EXPECT_NEAR(J.bvalue()[i][w], Jw.bvalue()[i], 1e-12);
+    }
+  }
+}
+
+// The LU-based inverse and determinant pivot independently in each lane
+TEST(test_a2dsimd, MatInvDetLU) {
+  constexpr int N = 5;
+  Mat<double, N, N> As[W];
+  for (int w = 0; w < W; w++) {
+    for (int i = 0; i < N * N; i++) {
+      As[w][i] = random_value() - 0.5;
+    }
+  }
+
+  Mat<Tb, N, N> A, Ainv;
+  BatchGather(W, As, A);
+  MatInv(A, Ainv);
+  Tb det;
+  MatDet(A, det);
+
+  for (int w = 0; w < W; w++) {
+    Mat<double, N, N> Ainvw;
+    double detw;
+    MatInv(As[w], Ainvw);
+    MatDet(As[w], detw);
+    EXPECT_NEAR(det[w], detw, 1e-14);
+    for (int i = 0; i < N * N; i++) {
+      EXPECT_NEAR(Ainv[i][w], Ainvw[i], 1e-12);
+    }
+  }
+}
@@ -0,0 +1,617 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "a2dcore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+// Fill the entries that the uninit constructor leaves unset with NaN so that
+// any read before eval() or forward() shows up in the results
+template <class Obj>
+void poison(A2DObj<Obj>& obj) {
+  for (int i = 0; i < Obj::ncomp; i++) {
+    obj.value()[i] = std::numeric_limits<double>::quiet_NaN();
+    obj.pvalue()[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+}
+
+// Intermediates constructed with uninit must give the same results as the
+// zero-initialized intermediates for all of the stack operations
+TEST(test_a2dstack, UninitIntermediates) {
+  using T = double;
+  constexpr int N = 6;
+  A2DObj<Mat<T, N, N>> Uxi, J, Uxi0, J0;
+  for (int i = 0; i < N * N; i++) {
+    Uxi.value()[i] = Uxi0.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    Uxi.pvalue()[i] = Uxi0.pvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+    J.value()[i] = J0.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    J.pvalue()[i] = J0.pvalue()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < N; i++) {
+    J.value()(i, i) += N;
+    J0.value()(i, i) += N;
+  }
+
+  A2DObj<Mat<T, N, N>> Jinv(uninit), Ux(uninit);
+  A2DObj<SymMat<T, N>> E(uninit);
+  A2DObj<T> output(uninit);
+  poison(Jinv);
+  poison(Ux);
+  poison(E);
+
+  A2DObj<Mat<T, N, N>> Jinv0, Ux0;
+  A2DObj<SymMat<T, N>> E0;
+  A2DObj<T> output0;
+
+  auto stack = MakeStack(MatInv(J, Jinv), MatMatMult(Uxi, Jinv, Ux),
+                         SymMatRK<MatOp::TRANSPOSE>(Ux, E),
+                         SymMatMultTrace(E, E, output));
+  auto stack0 = MakeStack(MatInv(J0, Jinv0), MatMatMult(Uxi0, Jinv0, Ux0),
+                          SymMatRK<MatOp::TRANSPOSE>(Ux0, E0),
+                          SymMatMultTrace(E0, E0, output0));
+
+  output.bvalue() = output0.bvalue() = 1.0;
+  stack.hproduct();
+  stack0.hproduct();
+
+  EXPECT_DOUBLE_EQ(output.value(), output0.value());
+  for (int i = 0; i < N * N; i++) {
+    EXPECT_DOUBLE_EQ(Uxi.bvalue()[i], Uxi0.bvalue()[i]);
+    EXPECT_DOUBLE_EQ(J.bvalue()[i], J0.bvalue()[i]);
+    EXPECT_DOUBLE_EQ(Uxi.hvalue()[i], Uxi0.hvalue()[i]);
+    EXPECT_DOUBLE_EQ(J.hvalue()[i], J0.hvalue()[i]);
+  }
+
+  // Extract the Hessian with respect to Uxi
+  Mat<T, N * N, N * N> jac, jac0;
+  stack.bzero();
+  stack0.bzero();
+  Uxi.bvalue().zero();
+  Uxi0.bvalue().zero();
+  output.bvalue() = output0.bvalue() = 1.0;
+  stack.hextract(Uxi.pvalue(), Uxi.hvalue(), jac);
+  stack0.hextract(Uxi0.pvalue(), Uxi0.hvalue(), jac0);
+
+  for (int i = 0; i < N * N; i++) {
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_DOUBLE_EQ(jac(i, j), jac0(i, j));
+    }
+  }
+}
+
+// bzero() zeros the seeds of the operation outputs, not the inputs
+TEST(test_a2dstack, BzeroOutputsOnly) {
+  using T = double;
+  constexpr int N = 3;
+  ADObj<Mat<T, N, N>> A, B, C;
+  ADObj<T> tr;
+
+  auto stack = MakeStack(MatSum(T(2.0), A, T(3.0), B, C), MatTrace(C, tr));
+  tr.bvalue() = 1.0;
+  stack.reverse();
+  EXPECT_DOUBLE_EQ(B.bvalue()(0, 0), 3.0);
+
+  stack.bzero();
+  EXPECT_DOUBLE_EQ(B.bvalue()(0, 0), 3.0);
+  EXPECT_DOUBLE_EQ(C.bvalue()(0, 0), 0.0);
+  EXPECT_DOUBLE_EQ(tr.bvalue(), 0.0);
+}
+
+// Extract the Hessian of the strain energy with respect to Uxi using K
+// directions per sweep and compare with the column-by-column extraction
+template <int K>
+void test_hextract_block() {
+  using T = double;
+  using Tb = simd<T, K>;
+  constexpr int N = 3;
+
+  Mat<T, N, N> Uxi0, J0;
+  for (int i = 0; i < N * N; i++) {
+    Uxi0[i] = static_cast<T>(rand()) / RAND_MAX;
+    J0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < N; i++) {
+    J0(i, i) += N;
+  }
+
+  A2DObj<Mat<T, N, N>> Uxi(Uxi0), J(J0), Jinv, Ux;
+  A2DObj<SymMat<T, N>> E, S;
+  A2DObj<T> output;
+  auto stack = MakeStack(MatInv(J, Jinv), MatMatMult(Uxi, Jinv, Ux),
+                         SymMatRK<MatOp::TRANSPOSE>(Ux, E),
+                         SymIsotropic(T(0.35), T(0.51), E, S),
+                         SymMatMultTrace(E, S, output));
+  output.bvalue() = 1.0;
+  Mat<T, N * N, N * N> jac;
+  stack.hextract(Uxi.pvalue(), Uxi.hvalue(), jac);
+
+  // Broadcast the values to all the lanes
+  A2DObj<Mat<Tb, N, N>> Uxib, Jb, Jinvb, Uxb;
+  A2DObj<SymMat<Tb, N>> Eb, Sb;
+  A2DObj<Tb> outputb;
+  for (int i = 0; i < N * N; i++) {
+    Uxib.value()[i] = Uxi0[i];
+    Jb.value()[i] = J0[i];
+  }
+  auto stackb = MakeStack(MatInv(Jb, Jinvb), MatMatMult(Uxib, Jinvb, Uxb),
+                          SymMatRK<MatOp::TRANSPOSE>(Uxb, Eb),
+                          SymIsotropic(T(0.35), T(0.51), Eb, Sb),
+                          SymMatMultTrace(Eb, Sb, outputb));
+  outputb.bvalue() = 1.0;
+  Mat<T, N * N, N * N> jacb;
+  stackb.template hextract_block<K>(Uxib.pvalue(), Uxib.hvalue(), jacb);
+
+  // Extract only the lower triangle into packed storage
+  SymMat<T, N * N> jacs, jacbs;
+  stack.bzero();
+  stackb.bzero();
+  output.bvalue() = 1.0;
+  outputb.bvalue() = 1.0;
+  stack.hextract(Uxi.pvalue(), Uxi.hvalue(), jacs);
+  stackb.template hextract_block<K>(Uxib.pvalue(), Uxib.hvalue(), jacbs);
+
+  for (int i = 0; i < N * N; i++) {
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_NEAR(jacb(i, j), jac(i, j), 1e-13);
+    }
+    for (int j = 0; j <= i; j++) {
+      EXPECT_NEAR(jacs(i, j), jac(i, j), 1e-13);
+      EXPECT_NEAR(jacbs(i, j), jac(i, j), 1e-13);
+    }
+  }
+}
+
+TEST(test_a2dstack, HExtractBlock) {
+  test_hextract_block<1>();
+  test_hextract_block<2>();
+  test_hextract_block<4>();
+  test_hextract_block<8>();
+}
+
+// Column ranges extracted by separate stacks over separate objects must
+// assemble the same Jacobian as a single hextract
+TEST(test_a2dstack, HExtractRange) {
+  using T = double;
+  constexpr int N = 3;
+
+  Mat<T, N, N> Uxi0;
+  for (int i = 0; i < N * N; i++) {
+    Uxi0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  auto extract = [&](index_t begin, index_t end, Mat<T, N * N, N * N>& jac,
+                     SymMat<T, N * N>& jacs) {
+    A2DObj<Mat<T, N, N>> Uxi(Uxi0);
+    A2DObj<SymMat<T, N>> E, S;
+    A2DObj<T> output;
+    auto stack =
+        MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Uxi, E),
+                  SymIsotropic(T(0.35), T(0.51), E, S),
+                  SymMatMultTrace(E, S, output));
+    output.bvalue() = 1.0;
+    stack.hextract_range(Uxi.pvalue(), Uxi.hvalue(), jac, begin, end);
+    stack.bzero();
+    output.bvalue() = 1.0;
+    stack.hextract_range(Uxi.pvalue(), Uxi.hvalue(), jacs, begin, end);
+  };
+
+  Mat<T, N * N, N * N> jac, jacr;
+  SymMat<T, N * N> jacs, jacsr;
+  extract(0, N * N, jac, jacs);
+  extract(0, 2, jacr, jacsr);
+  extract(2, 7, jacr, jacsr);
+  extract(7, N * N, jacr, jacsr);
+
+  for (int i = 0; i < N * N; i++) {
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_EQ(jacr(i, j), jac(i, j));
+    }
+    for (int j = 0; j <= i; j++) {
+      EXPECT_EQ(jacsr(i, j), jacs(i, j));
+    }
+  }
+}
+
+// Extract the Jacobian of the stress with respect to Uxi with K adjoints per
+// reverse sweep and compare with the row-by-row and forward extractions
+template <int K>
+void test_rextract_block() {
+  using T = double;
+  using Tb = simd<T, K>;
+  constexpr int N = 3;
+  constexpr int M = N * (N + 1) / 2;
+
+  Mat<T, N, N> Uxi0, J0;
+  for (int i = 0; i < N * N; i++) {
+    Uxi0[i] = static_cast<T>(rand()) / RAND_MAX;
+    J0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < N; i++) {
+    J0(i, i) += N;
+  }
+
+  ADObj<Mat<T, N, N>> Uxi(Uxi0), J(J0), Jinv, Ux;
+  ADObj<SymMat<T, N>> E, S;
+  auto stack = MakeStack(MatInv(J, Jinv), MatMatMult(Uxi, Jinv, Ux),
+                         SymMatRK<MatOp::TRANSPOSE>(Ux, E),
+                         SymIsotropic(T(0.35), T(0.51), E, S));
+  Mat<T, M, N * N> jac;
+  stack.rextract(S.bvalue(), Uxi.bvalue(), jac);
+
+  // Each column of the Jacobian from a forward sweep. The reverse sweeps
+  // also accumulate into the seed of J, which is not an output.
+  J.bvalue().zero();
+  for (int j = 0; j < N * N; j++) {
+    Uxi.bvalue().zero();
+    Uxi.bvalue()[j] = 1.0;
+    stack.forward();
+    for (int i = 0; i < M; i++) {
+      EXPECT_NEAR(jac(i, j), S.bvalue()[i], 1e-13);
+    }
+  }
+
+  // Broadcast the values to all the lanes
+  ADObj<Mat<Tb, N, N>> Uxib, Jb, Jinvb, Uxb;
+  ADObj<SymMat<Tb, N>> Eb, Sb;
+  for (int i = 0; i < N * N; i++) {
+    Uxib.value()[i] = Uxi0[i];
+    Jb.value()[i] = J0[i];
+  }
+  auto stackb = MakeStack(MatInv(Jb, Jinvb), MatMatMult(Uxib, Jinvb, Uxb),
+                          SymMatRK<MatOp::TRANSPOSE>(Uxb, Eb),
+                          SymIsotropic(T(0.35), T(0.51), Eb, Sb));
+  Mat<T, M, N * N> jacb;
+  stackb.template rextract_block<K>(Sb.bvalue(), Uxib.bvalue(), jacb);
+
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_NEAR(jacb(i, j), jac(i, j), 1e-13);
+    }
+  }
+}
+
+TEST(test_a2dstack, RExtractBlock) {
+  test_rextract_block<1>();
+  test_rextract_block<2>();
+  test_rextract_block<4>();
+  test_rextract_block<8>();
+}
+
+// The output sum_i d_i u_i^2 couples each data component to one state
+// component, so the Jacobians are diagonal and need a single sweep
+TEST(test_a2dstack, ExtractJacobianCompressed) {
+  using T = double;
+  constexpr int N = 6;
+  A2DObj<Vec<T, N>> d, u, w;
+  A2DObj<Vec<T, 3>> x;
+  A2DObj<T> output;
+  for (int i = 0; i < N; i++) {
+    d.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    u.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  auto stack = MakeStack(VecHadamard(d, u, w), VecDot(w, u, output));
+  output.bvalue() = 1.0;
+
+  JacobianPattern<N, N> pss, pds;
+  ExtractJacobianPattern<FEVarType::STATE, FEVarType::STATE>(stack, d, x, u,
+                                                             pss);
+  ExtractJacobianPattern<FEVarType::DATA, FEVarType::STATE>(stack, d, x, u,
+                                                            pds);
+  EXPECT_EQ(pss.num_colors, 1);
+  EXPECT_EQ(pss.get_num_nonzeros(), N);
+  EXPECT_EQ(pds.num_colors, 1);
+  EXPECT_EQ(pds.get_num_nonzeros(), N);
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < N; j++) {
+      EXPECT_EQ(pss(i, j), i == j);
+      EXPECT_EQ(pds(i, j), i == j);
+    }
+  }
+
+  // Each extraction runs reverse(), so reset the first-order seeds first
+  auto reseed = [&]() {
+    stack.bzero();
+    output.bvalue() = 1.0;
+  };
+
+  SymMat<T, N> jss, jss0;
+  Mat<T, N, N> jds, jds0;
+  reseed();
+  ExtractJacobian<FEVarType::STATE, FEVarType::STATE>(stack, d, x, u, pss, jss);
+  reseed();
+  ExtractJacobian<FEVarType::DATA, FEVarType::STATE>(stack, d, x, u, pds, jds);
+  reseed();
+  ExtractJacobian<FEVarType::STATE, FEVarType::STATE>(stack, d, x, u, jss0);
+  reseed();
+  ExtractJacobian<FEVarType::DATA, FEVarType::STATE>(stack, d, x, u, jds0);
+
+  for (int i = 0; i < N; i++) {
+    EXPECT_NEAR(jss(i, i), 2.0 * d.value()[i], 1e-14);
+    EXPECT_NEAR(jds(i, i), 2.0 * u.value()[i], 1e-14);
+    for (int j = 0; j < N; j++) {
+      EXPECT_NEAR(jss(i, j), jss0(i, j), 1e-14);
+      EXPECT_NEAR(jds(i, j), jds0(i, j), 1e-14);
+    }
+  }
+}
+
+// Columns that share a row must get different colors
+TEST(test_a2dstack, JacobianPatternColoring) {
+  JacobianPattern<3, 4> pattern;
+  pattern(0, 0) = pattern(0, 1) = true;
+  pattern(1, 1) = pattern(1, 2) = true;
+  pattern(2, 3) = true;
+  pattern.color_columns();
+
+  EXPECT_EQ(pattern.num_colors, 2);
+  EXPECT_EQ(pattern.color[0], 0);
+  EXPECT_EQ(pattern.color[1], 1);
+  EXPECT_EQ(pattern.color[2], 0);
+  EXPECT_EQ(pattern.color[3], 0);
+}
+
+// The state enters the stack after the inverse of the data matrix, so the
+// Hessian with respect to the state only sweeps the operations after it
+TEST(test_a2dstack, HExtractLateInput) {
+  using T = double;
+  constexpr int N = 3;
+  A2DObj<Mat<T, N, N>> J, Jinv;
+  A2DObj<Vec<T, N>> u, y;
+  A2DObj<T> output;
+  for (int i = 0; i < N * N; i++) {
+    J.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < N; i++) {
+    J.value()(i, i) += N;
+    u.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  auto stack = MakeStack(MatInv(J, Jinv), MatVecMult(Jinv, u, y),
+                         VecDot(y, y, output));
+  static_assert(decltype(stack)::first_reference<Vec<T, N>>() == 1);
+  static_assert(decltype(stack)::first_reference<Mat<T, N, N>>() == 0);
+  static_assert(decltype(stack)::first_reference<SymMat<T, N>>() == 3);
+
+  output.bvalue() = 1.0;
+  SymMat<T, N> jac;
+  stack.hextract(u.pvalue(), u.hvalue(), jac);
+
+  // The Hessian of |J^{-1} u|^2 is 2 J^{-T} J^{-1}
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++) {
+      T h = 0.0;
+      for (int k = 0; k < N; k++) {
+        h += 2.0 * Jinv.value()(k, i) * Jinv.value()(k, j);
+      }
+      EXPECT_NEAR(jac(i, j), h, 1e-14);
+    }
+  }
+}
+
+// Products with the recorded Jacobian must match the products computed with
+// the stack at the same point
+TEST(test_a2dstack, LinearizedJacobian) {
+  using T = double;
+  constexpr int N = 6;
+  A2DObj<Vec<T, N>> d, u, w;
+  A2DObj<Vec<T, 3>> x;
+  A2DObj<T> output;
+  for (int i = 0; i < N; i++) {
+    d.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+    u.value()[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  auto stack = MakeStack(VecHadamard(d, u, w), VecDot(w, u, output));
+
+  LinearizedJacobian<FEVarType::STATE, FEVarType::STATE, SymMat<T, N>> jss;
+  LinearizedJacobian<FEVarType::DATA, FEVarType::STATE, Mat<T, N, N>> jds;
+  output.bvalue() = 1.0;
+  jss.linearize(stack, d, x, u);
+  stack.bzero();
+  output.bvalue() = 1.0;
+  jds.linearize(stack, d, x, u);
+
+  for (int k = 0; k < 3; k++) {
+    Vec<T, N> p, rss, rds, rss0, rds0;
+    for (int i = 0; i < N; i++) {
+      p[i] = static_cast<T>(rand()) / RAND_MAX;
+    }
+    JacobianProduct(jss, p, rss);
+    JacobianProduct(jds, p, rds);
+
+    stack.bzero();
+    output.bvalue() = 1.0;
+    d.pvalue().zero();
+    d.hvalue().zero();
+    u.hvalue().zero();
+    stack.hzero();
+    JacobianProduct<FEVarType::STATE, FEVarType::STATE>(stack, d, x, u, p,
+                                                        rss0);
+    stack.bzero();
+    output.bvalue() = 1.0;
+    d.hvalue().zero();
+    u.hvalue().zero();
+    stack.hzero();
+    JacobianProduct<FEVarType::DATA, FEVarType::STATE>(stack, d, x, u, p,
+                                                       rds0);
+
+    for (int i = 0; i < N; i++) {
+      EXPECT_NEAR(rss[i], rss0[i], 1e-14);
+      EXPECT_NEAR(rds[i], rds0[i], 1e-14);
+    }
+  }
+}
+
+// The fused stack must give the same gradient and Hessian as the unfused
+// stack, and fall back to the unfused operations when the trace doesn't take
+// the strain and stress of the constitutive operation
+TEST(test_a2dstack, FusedStack) {
+  using T = double;
+  constexpr int N = 3;
+  Mat<T, N, N> Ux0;
+  for (int i = 0; i < N * N; i++) {
+    Ux0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  A2DObj<Mat<T, N, N>> Ux(Ux0), Uxf(Ux0), Uxg(Ux0);
+  A2DObj<SymMat<T, N>> E, S, Ef, Sf, Eg, Sg;
+  A2DObj<T> output, outputf, outputg;
+  auto stack =
+      MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                SymIsotropic(T(0.35), T(0.51), E, S),
+                SymMatMultTrace(E, S, output));
+  auto stackf =
+      MakeFusedStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Uxf, Ef),
+                     SymIsotropic(T(0.35), T(0.51), Ef, Sf),
+                     SymMatMultTrace(Ef, Sf, outputf));
+  auto stackg =
+      MakeFusedStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Uxg, Eg),
+                     SymIsotropic(T(0.35), T(0.51), Eg, Sg),
+                     SymMatMultTrace(Sg, Sg, outputg));
+  static_assert(decltype(stack)::num_ops == 3);
+  static_assert(decltype(stackf)::num_ops == 2);
+  static_assert(decltype(stackg)::num_ops == 2);
+
+  EXPECT_NEAR(outputf.value(), output.value(), 1e-14);
+
+  output.bvalue() = outputf.bvalue() = outputg.bvalue() = 1.0;
+  Mat<T, N * N, N * N> jac, jacf, jacg;
+  stack.hextract(Ux.pvalue(), Ux.hvalue(), jac);
+  stackf.hextract(Uxf.pvalue(), Uxf.hvalue(), jacf);
+  stackg.hextract(Uxg.pvalue(), Uxg.hvalue(), jacg);
+
+  for (int i = 0; i < N * N; i++) {
+    EXPECT_NEAR(Uxf.bvalue()[i], Ux.bvalue()[i], 1e-14);
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_NEAR(jacf(i, j), jac(i, j), 1e-13);
+    }
+  }
+
+  // The unfused reference for tr(S * S)
+  A2DObj<Mat<T, N, N>> Uxh(Ux0);
+  A2DObj<SymMat<T, N>> Eh, Sh;
+  A2DObj<T> outputh;
+  auto stackh = MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Uxh, Eh),
+                          SymIsotropic(T(0.35), T(0.51), Eh, Sh),
+                          SymMatMultTrace(Sh, Sh, outputh));
+  outputh.bvalue() = 1.0;
+  Mat<T, N * N, N * N> jach;
+  stackh.hextract(Uxh.pvalue(), Uxh.hvalue(), jach);
+  for (int i = 0; i < N * N; i++) {
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_NEAR(jacg(i, j), jach(i, j), 1e-13);
+    }
+  }
+}
+
+// The pair is not fused when a later operation uses the stress, since the
+// fused operation doesn't compute its seeds
+TEST(test_a2dstack, FusedStackLaterUse) {
+  using T = double;
+  constexpr int N = 3;
+  Mat<T, N, N> Ux0;
+  for (int i = 0; i < N * N; i++) {
+    Ux0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  A2DObj<Mat<T, N, N>> Ux(Ux0), Uxf(Ux0);
+  A2DObj<SymMat<T, N>> E, S, Ef, Sf;
+  A2DObj<T> energy, stress, energyf, stressf;
+  auto stack = MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                         SymIsotropic(T(0.35), T(0.51), E, S),
+                         SymMatMultTrace(E, S, energy),
+                         SymMatMultTrace(S, S, stress));
+  auto stackf =
+      MakeFusedStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Uxf, Ef),
+                     SymIsotropic(T(0.35), T(0.51), Ef, Sf),
+                     SymMatMultTrace(Ef, Sf, energyf),
+                     SymMatMultTrace(Sf, Sf, stressf));
+  static_assert(decltype(stackf)::num_ops == 4);
+
+  energy.bvalue() = stress.bvalue() = 1.0;
+  energyf.bvalue() = stressf.bvalue() = 1.0;
+  Mat<T, N * N, N * N> jac, jacf;
+  stack.hextract(Ux.pvalue(), Ux.hvalue(), jac);
+  stackf.hextract(Uxf.pvalue(), Uxf.hvalue(), jacf);
+  for (int i = 0; i < N * N; i++) {
+    EXPECT_NEAR(Uxf.bvalue()[i], Ux.bvalue()[i], 1e-14);
+    for (int j = 0; j < N * N; j++) {
+      EXPECT_NEAR(jacf(i, j), jac(i, j), 1e-13);
+    }
+  }
+}
+
+// The same check for a first-order stack of ADObj objects
+TEST(test_a2dstack, FusedStackLaterUseFirstOrder) {
+  using T = double;
+  constexpr int N = 3;
+  SymMat<T, N> E0;
+  for (int i = 0; i < E0.ncomp; i++) {
+    E0[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  ADObj<SymMat<T, N>> E(E0), S, Ef(E0), Sf;
+  ADObj<T> energy, stress, energyf, stressf;
+  auto stack = MakeStack(SymIsotropic(T(0.35), T(0.51), E, S),
+                         SymMatMultTrace(E, S, energy),
+                         SymMatMultTrace(S, S, stress));
+  auto stackf = MakeFusedStack(SymIsotropic(T(0.35), T(0.51), Ef, Sf),
+                               SymMatMultTrace(Ef, Sf, energyf),
+                               SymMatMultTrace(Sf, Sf, stressf));
+  static_assert(decltype(stackf)::num_ops == 3);
+
+  energy.bvalue() = stress.bvalue() = 1.0;
+  energyf.bvalue() = stressf.bvalue() = 1.0;
+  stack.reverse();
+  stackf.reverse();
+  for (int i = 0; i < E0.ncomp; i++) {
+    EXPECT_NEAR(Ef.bvalue()[i], E.bvalue()[i], 1e-14);
+  }
+}
+
+// A plan rebound to the data of each element must give the same values and
+// derivatives as a stack built for that element
+TEST(test_a2dstack, StackPlan) {
+  using T = double;
+  constexpr int N = 3, nelems = 4;
+  T u[N * N * nelems], ub[N * N * nelems];
+  for (int i = 0; i < N * N * nelems; i++) {
+    u[i] = static_cast<T>(rand()) / RAND_MAX;
+    ub[i] = 0.0;
+  }
+
+  auto plan =
+      MakeStackPlan<A2DObj<MatView<T, N, N>>, A2DObj<SymMat<T, N>>,
+                    A2DObj<SymMat<T, N>>, A2DObj<T>>(
+          [](auto& Ux, auto& E, auto& S, auto& output) {
+            return MakeStack(uninit,
+                             MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                             SymIsotropic(T(0.35), T(0.51), E, S),
+                             SymMatMultTrace(E, S, output));
+          });
+
+  for (int e = 0; e < nelems; e++) {
+    plan.rebind<0>(&u[N * N * e], &ub[N * N * e]);
+    plan.eval();
+    plan.get_stack().bzero();
+    plan.get<3>().bvalue() = 1.0;
+    plan.get_stack().reverse();
+
+    A2DObj<Mat<T, N, N>> Ux;
+    for (int i = 0; i < N * N; i++) {
+      Ux.value()[i] = u[N * N * e + i];
+    }
+    A2DObj<SymMat<T, N>> E, S;
+    A2DObj<T> output;
+    auto stack = MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                           SymIsotropic(T(0.35), T(0.51), E, S),
+                           SymMatMultTrace(E, S, output));
+    output.bvalue() = 1.0;
+    stack.reverse();
+
+    EXPECT_NEAR(plan.get<3>().value(), output.value(), 1e-14);
+    for (int i = 0; i < N * N; i++) {
+      EXPECT_NEAR(ub[N * N * e + i], Ux.bvalue()[i], 1e-14);
+    }
+  }
+}
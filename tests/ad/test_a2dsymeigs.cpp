@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "a2ddefs.h"
+#include "ad/a2dmat.h"
+#include "ad/a2dsymeigs.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+// Check A * Q = Q * diag(eigs), Q^{T} * Q = I and the eigenvalue order (up
+// to round-off for repeated roots), and compare the eigenvalues against the
+// general solver
+void check_sym_eigs_3x3(const double A[]) {
+  double eigs[3], Q[9], evals[3], ref[3];
+  SymEigs3x3(A, eigs, Q);
+  SymEigs3x3(A, evals);
+  SymEigsGeneral<double, 3>(A, ref);
+  std::sort(ref, ref + 3);
+
+  double scale = 0.0;
+  for (int i = 0; i < 6; i++) {
+    scale = std::max(scale, std::fabs(A[i]));
+  }
+  const double tol = 1e-14 * std::max(scale, 1.0);
+
+  EXPECT_LE(eigs[0], eigs[1] + tol);
+  EXPECT_LE(eigs[1], eigs[2] + tol);
+  for (int k = 0; k < 3; k++) {
+    EXPECT_NEAR(eigs[k], ref[k], tol);
+    EXPECT_DOUBLE_EQ(evals[k], eigs[k]);
+  }
+
+  for (int k = 0; k < 3; k++) {
+    double q[3] = {Q[k], Q[3 + k], Q[6 + k]}, Aq[3];
+    SymMatVecCore<double, 3>(A, q, Aq);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_NEAR(Aq[i], eigs[k] * q[i], tol);
+    }
+    for (int j = 0; j < 3; j++) {
+      double dot = Q[k] * Q[j] + Q[3 + k] * Q[3 + j] + Q[6 + k] * Q[6 + j];
+      EXPECT_NEAR(dot, (j == k ? 1.0 : 0.0), 1e-14);
+    }
+  }
+}
+
+TEST(test_a2dsymeigs, SymEigs3x3Random) {
+  for (int iter = 0; iter < 100; iter++) {
+    double A[6];
+    for (int i = 0; i < 6; i++) {
+      A[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+    }
+    check_sym_eigs_3x3(A);
+  }
+}
+
+TEST(test_a2dsymeigs, SymEigs3x3Repeated) {
+  // Packed storage: a00, a10, a11, a20, a21, a22
+  const double cases[][6] = {
+      {2.0, 0.0, 2.0, 0.0, 0.0, 2.0},        // Triple root
+      {1.0, 0.0, 1.0, 0.0, 0.0, 3.0},        // Double root, diagonal
+      {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},        // Zero matrix
+      {2.0, 1.0, 2.0, 1.0, 1.0, 2.0},        // Eigenvalues 1, 1, 4
+      {1.0, 1e-9, 1.0, 0.0, 1e-9, 1.0},      // Nearly a triple root
+      {1.0, 1e-12, 1.0 + 1e-12, 0.0, 0.0, -2.0},  // Nearly a double root
+      {1e6, 1.0, 1e6, 0.0, 0.0, 1e-6}};      // Badly scaled
+
+  for (const auto& A : cases) {
+    check_sym_eigs_3x3(A);
+  }
+}
+
+template <int N>
+void random_sym_matrix(double A[]) {
+  for (int i = 0; i < N * (N + 1) / 2; i++) {
+    A[i] = static_cast<double>(rand()) / RAND_MAX - 0.5;
+  }
+}
+
+TEST(test_a2dsymeigs, SymEigsGeneralStats) {
+  constexpr int N = 6, ncalls = 20;
+  SymEigsStats stats;
+  SymEigsOptions options;
+  options.stats = &stats;
+
+  for (int iter = 0; iter < ncalls; iter++) {
+    double A[N * (N + 1) / 2], eigs[N], Q[N * N];
+    random_sym_matrix<N>(A);
+    EXPECT_TRUE((SymEigsGeneral<double, N>(A, eigs, Q, options)));
+  }
+
+  EXPECT_EQ(stats.calls, ncalls);
+  EXPECT_EQ(stats.failures, 0);
+  EXPECT_GT(stats.average_iterations(), 0.0);
+
+  // Each eigenvalue converges in a few implicit QL sweeps, so the total is
+  // well below the old fixed count of 30 sweeps per eigenvalue
+  EXPECT_LT(stats.average_iterations(), 4.0 * N);
+}
+
+TEST(test_a2dsymeigs, SymEigsGeneralTolerance) {
+  constexpr int N = 5;
+  SymEigsStats exact_stats, loose_stats;
+  SymEigsOptions exact, loose;
+  exact.stats = &exact_stats;
+  loose.stats = &loose_stats;
+  loose.tol = 1e-8;
+
+  for (int iter = 0; iter < 20; iter++) {
+    double A[N * (N + 1) / 2], eigs[N], eigs_loose[N];
+    random_sym_matrix<N>(A);
+    EXPECT_TRUE((SymEigsGeneral<double, N>(A, eigs, nullptr, exact)));
+    EXPECT_TRUE((SymEigsGeneral<double, N>(A, eigs_loose, nullptr, loose)));
+
+    std::sort(eigs, eigs + N);
+    std::sort(eigs_loose, eigs_loose + N);
+    for (int k = 0; k < N; k++) {
+      EXPECT_NEAR(eigs[k], eigs_loose[k], 1e-8);
+    }
+  }
+
+  EXPECT_LE(loose_stats.iterations, exact_stats.iterations);
+}
+
+TEST(test_a2dsymeigs, SymEigsGeneralMaxIterations) {
+  constexpr int N = 6;
+  SymEigsStats stats;
+  SymEigsOptions options;
+  options.max_iters = 1;
+  options.stats = &stats;
+
+  double A[N * (N + 1) / 2], eigs[N];
+  random_sym_matrix<N>(A);
+  EXPECT_FALSE((SymEigsGeneral<double, N>(A, eigs, nullptr, options)));
+  EXPECT_EQ(stats.calls, 1);
+  EXPECT_GT(stats.failures, 0);
+}
+
+// An eigenvalue that converges on the last allowed sweep is not a failure
+TEST(test_a2dsymeigs, TriSymEigsConvergesOnLastSweep) {
+  // A 2 x 2 tridiagonal matrix is diagonalized by one shifted QL sweep
+  double alpha[2] = {1.0, 3.0}, beta[2] = {0.5, 0.0};
+  SymEigsStats stats;
+  SymEigsOptions options;
+  options.max_iters = 1;
+  options.stats = &stats;
+  EXPECT_TRUE((TriSymEigs<double, 2>(alpha, beta, nullptr, options)));
+  EXPECT_EQ(stats.iterations, 1);
+  EXPECT_EQ(stats.failures, 0);
+
+  // A diagonal matrix needs no sweep
+  double d[3] = {1.0, 2.0, 3.0}, e[3] = {0.0, 0.0, 0.0};
+  options.max_iters = 0;
+  EXPECT_TRUE((TriSymEigs<double, 3>(d, e, nullptr, options)));
+  EXPECT_EQ(stats.failures, 0);
+}
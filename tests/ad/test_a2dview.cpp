@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "a2dcore.h"
+#include "test_commons.h"
+
+using namespace A2D;
+
+TEST(test_a2dview, Traits) {
+  using T = double;
+  EXPECT_TRUE((is_a2d_matrix<MatView<T, 3, 2>>::value));
+  EXPECT_TRUE((is_a2d_sym_matrix<SymMatView<T, 3>>::value));
+  EXPECT_TRUE((is_a2d_vector<VecView<T, 3>>::value));
+  EXPECT_EQ((get_matrix_rows<MatView<T, 3, 2>>::size), 3);
+  EXPECT_EQ((get_matrix_columns<MatView<T, 3, 2>>::size), 2);
+  EXPECT_EQ((get_symmatrix_size<A2DObj<SymMatView<T, 4>>>::size), 4);
+  EXPECT_EQ((get_vec_size<ADObj<VecView<T, 5>>>::size), 5);
+  EXPECT_TRUE((get_a2d_object_type<SymMatView<T, 3>>::value ==
+               ADObjType::SYMMAT));
+}
+
+// Copy construction aliases the data, assignment copies the entries
+TEST(test_a2dview, Semantics) {
+  double a[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, b[6];
+  SymMatView<double, 3> A(a), B(b);
+  SymMatView<double, 3> C(A);
+  EXPECT_EQ(C.get_data(), a);
+
+  B = A;
+  EXPECT_EQ(B.get_data(), b);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_DOUBLE_EQ(B(i, j), A(i, j));
+    }
+  }
+
+  C.zero();
+  EXPECT_DOUBLE_EQ(a[5], 0.0);
+  C.rebind(b);
+  EXPECT_DOUBLE_EQ(C(2, 2), 6.0);
+}
+
+// Evaluate the strain energy of several elements with the values and seeds
+// stored in global arrays and compare with the gather/scatter version
+TEST(test_a2dview, GlobalSeeds) {
+  using T = double;
+  constexpr int N = 3, nelems = 4, size = N * N;
+  const T mu = 0.35, lambda = 0.51;
+
+  T u[nelems * size], up[nelems * size];
+  T ub[nelems * size] = {0.0}, uh[nelems * size] = {0.0};
+  T x[nelems * N];
+  for (int i = 0; i < nelems * size; i++) {
+    u[i] = static_cast<T>(rand()) / RAND_MAX;
+    up[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+  for (int i = 0; i < nelems * N; i++) {
+    x[i] = static_cast<T>(rand()) / RAND_MAX;
+  }
+
+  for (int e = 0; e < nelems; e++) {
+    // The values and seeds live in the global arrays
+    A2DObj<MatView<T, N, N>> Ux(
+        MatView<T, N, N>(&u[size * e]), MatView<T, N, N>(&ub[size * e]),
+        MatView<T, N, N>(&up[size * e]), MatView<T, N, N>(&uh[size * e]));
+    VecView<T, N> xe(&x[N * e]);
+    A2DObj<Vec<T, N>> y;
+    A2DObj<SymMat<T, N>> E, S;
+    A2DObj<T> energy, output;
+
+    auto stack =
+        MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Ux, E),
+                  SymIsotropic(mu, lambda, E, S),
+                  SymMatMultTrace(E, S, energy), MatVecMult(Ux, xe, y),
+                  VecDot(y, y, output));
+    energy.bvalue() = 1.0;
+    output.bvalue() = 1.0;
+    stack.hproduct();
+
+    // Gather the element data into owning objects
+    A2DObj<Mat<T, N, N>> Ux0;
+    Vec<T, N> xe0;
+    for (int i = 0; i < size; i++) {
+      Ux0.value()[i] = u[size * e + i];
+      Ux0.pvalue()[i] = up[size * e + i];
+    }
+    for (int i = 0; i < N; i++) {
+      xe0[i] = x[N * e + i];
+    }
+    A2DObj<Vec<T, N>> y0;
+    A2DObj<SymMat<T, N>> E0, S0;
+    A2DObj<T> energy0, output0;
+
+    auto stack0 =
+        MakeStack(MatGreenStrain<GreenStrainType::NONLINEAR>(Ux0, E0),
+                  SymIsotropic(mu, lambda, E0, S0),
+                  SymMatMultTrace(E0, S0, energy0), MatVecMult(Ux0, xe0, y0),
+                  VecDot(y0, y0, output0));
+    energy0.bvalue() = 1.0;
+    output0.bvalue() = 1.0;
+    stack0.hproduct();
+
+    EXPECT_DOUBLE_EQ(energy.value(), energy0.value());
+    EXPECT_DOUBLE_EQ(output.value(), output0.value());
+    for (int i = 0; i < size; i++) {
+      EXPECT_DOUBLE_EQ(ub[size * e + i], Ux0.bvalue()[i]);
+      EXPECT_DOUBLE_EQ(uh[size * e + i], Ux0.hvalue()[i]);
+    }
+  }
+}
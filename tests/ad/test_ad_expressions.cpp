@@ -665,6 +665,7 @@ int main(int argc, char *argv[]) {
   tests.push_back(A2D::Test::SymMatVecMultTestAll);
   tests.push_back(A2D::Test::MatDetTestAll);
   tests.push_back(A2D::Test::MatInvTestAll);
+  tests.push_back(A2D::Test::MatSolveTestAll);
   tests.push_back(A2D::Test::MatTraceTestAll);
   tests.push_back(A2D::Test::MatGreenStrainTestAll);
   tests.push_back(A2D::Test::SymMatMultTraceTestAll);
@@ -681,6 +682,7 @@ int main(int argc, char *argv[]) {
   tests.push_back(A2D::Test::VecOuterTestAll);
   tests.push_back(A2D::Test::ScalarTestAll);
   tests.push_back(A2D::Test::SymEigsTestAll);
+  tests.push_back(A2D::Test::SymMatCholeskyTestAll);
   tests.push_back(A2D::Test::QuaternionMatrixTestAll);
   tests.push_back(A2D::Test::QuaternionAngularVelocityTestAll);
   tests.push_back(A2D::Test::VecHadamardTestAll);